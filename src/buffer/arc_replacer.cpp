@@ -0,0 +1,194 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+ARCReplacer::ARCReplacer(size_t num_pages, size_t correlated_window)
+    : capacity_(num_pages),
+      correlated_window_(correlated_window),
+      last_access_(num_pages),
+      resident_list_(num_pages, ResidentList::NONE),
+      position_(num_pages),
+      evictable_(num_pages) {}
+
+ARCReplacer::~ARCReplacer() = default;
+
+bool ARCReplacer::Victim(frame_id_t *frame_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+  frame_id_t t1_victim;
+  frame_id_t t2_victim;
+  bool t1_has_victim = FindEvictable(t1_, &t1_victim);
+  bool t2_has_victim = FindEvictable(t2_, &t2_victim);
+  // Evict from T1 while it is over its target, or when T2 has nothing to give.
+  bool from_t1 = t1_has_victim && (!t2_has_victim || t1_.size() >= std::max<size_t>(target_t1_size_, 1));
+  if (!from_t1 && !t2_has_victim) {
+    return false;
+  }
+  *frame_id = from_t1 ? t1_victim : t2_victim;
+  // The frame stays in its resident list until RecordEviction, which moves its page to the matching ghost list.
+  evictable_[*frame_id] = false;
+  size_--;
+  return true;
+}
+
+// A pin is a hit: the page has now been accessed more than once, unless the hit is correlated with the previous one.
+void ARCReplacer::Pin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (evictable_[frame_id]) {
+    evictable_[frame_id] = false;
+    size_--;
+  }
+  bool is_correlated = RecordAccess(frame_id);
+  if (resident_list_[frame_id] == ResidentList::NONE) {
+    MoveTo(frame_id, ResidentList::T1);
+  } else {
+    // 相关的访问(比如扫描连着读同一页的tuple)只算同一次访问, 留在原来的链表里
+    MoveTo(frame_id, is_correlated ? resident_list_[frame_id] : ResidentList::T2);
+  }
+}
+
+void ARCReplacer::Unpin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (evictable_[frame_id]) {
+    return;
+  }
+  if (resident_list_[frame_id] == ResidentList::NONE) {
+    MoveTo(frame_id, ResidentList::T1);
+  }
+  evictable_[frame_id] = true;
+  size_++;
+}
+
+void ARCReplacer::PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) {
+  std::lock_guard<std::mutex> lock(latch_);
+  // The list Victim prefers right now goes first. Later victims may come from the other list once T1 shrinks.
+  bool t1_first = t1_.size() >= std::max<size_t>(target_t1_size_, 1);
+  for (const std::list<frame_id_t> *list : {t1_first ? &t1_ : &t2_, t1_first ? &t2_ : &t1_}) {
+    for (auto iter = list->rbegin(); iter != list->rend() && frame_ids->size() < max_frames; ++iter) {
+      if (evictable_[*iter]) {
+        frame_ids->push_back(*iter);
+      }
+    }
+  }
+}
+
+void ARCReplacer::Remove(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+  Detach(frame_id);
+}
+
+void ARCReplacer::RecordLoad(frame_id_t frame_id, page_id_t page_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+  Detach(frame_id);
+  // 载入是新页的第一次访问, 不和这个frame上一个页的访问相关
+  last_access_[frame_id] = ++current_timestamp_;
+  auto b1_iter = b1_.map_.find(page_id);
+  if (b1_iter != b1_.map_.end()) {
+    // T1 evicted a page that was needed again: give T1 more room.
+    size_t delta = std::max<size_t>(b2_.list_.size() / b1_.list_.size(), 1);
+    target_t1_size_ = std::min(target_t1_size_ + delta, capacity_);
+    b1_.list_.erase(b1_iter->second);
+    b1_.map_.erase(b1_iter);
+    MoveTo(frame_id, ResidentList::T2);
+    return;
+  }
+  auto b2_iter = b2_.map_.find(page_id);
+  if (b2_iter != b2_.map_.end()) {
+    // T2 evicted a page that was needed again: give T2 more room.
+    size_t delta = std::max<size_t>(b1_.list_.size() / b2_.list_.size(), 1);
+    target_t1_size_ = target_t1_size_ > delta ? target_t1_size_ - delta : 0;
+    b2_.list_.erase(b2_iter->second);
+    b2_.map_.erase(b2_iter);
+    MoveTo(frame_id, ResidentList::T2);
+    return;
+  }
+  MoveTo(frame_id, ResidentList::T1);
+}
+
+void ARCReplacer::RecordEviction(frame_id_t frame_id, page_id_t page_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+  ResidentList from = resident_list_[frame_id];
+  Detach(frame_id);
+  if (from == ResidentList::NONE) {
+    return;
+  }
+  GhostList &ghost = from == ResidentList::T1 ? b1_ : b2_;
+  ghost.list_.push_front(page_id);
+  ghost.map_[page_id] = ghost.list_.begin();
+  // Keep |T1| + |B1| <= c and |T1| + |T2| + |B1| + |B2| <= 2c.
+  while (!b1_.list_.empty() && t1_.size() + b1_.list_.size() > capacity_) {
+    PopGhost(&b1_);
+  }
+  while (t1_.size() + t2_.size() + b1_.list_.size() + b2_.list_.size() > 2 * capacity_) {
+    PopGhost(b2_.list_.empty() ? &b1_ : &b2_);
+  }
+}
+
+size_t ARCReplacer::Size() {
+  std::lock_guard<std::mutex> lock(latch_);
+  return size_;
+}
+
+size_t ARCReplacer::GetTargetT1Size() {
+  std::lock_guard<std::mutex> lock(latch_);
+  return target_t1_size_;
+}
+
+bool ARCReplacer::RecordAccess(frame_id_t frame_id) {
+  uint64_t now = ++current_timestamp_;
+  uint64_t previous_access = last_access_[frame_id];
+  last_access_[frame_id] = now;
+  return previous_access != 0 && now - previous_access < correlated_window_;
+}
+
+void ARCReplacer::MoveTo(frame_id_t frame_id, ResidentList target) {
+  if (resident_list_[frame_id] != ResidentList::NONE) {
+    (resident_list_[frame_id] == ResidentList::T1 ? t1_ : t2_).erase(position_[frame_id]);
+  }
+  std::list<frame_id_t> &list = target == ResidentList::T1 ? t1_ : t2_;
+  list.push_front(frame_id);
+  position_[frame_id] = list.begin();
+  resident_list_[frame_id] = target;
+}
+
+void ARCReplacer::Detach(frame_id_t frame_id) {
+  if (evictable_[frame_id]) {
+    evictable_[frame_id] = false;
+    size_--;
+  }
+  if (resident_list_[frame_id] != ResidentList::NONE) {
+    (resident_list_[frame_id] == ResidentList::T1 ? t1_ : t2_).erase(position_[frame_id]);
+    resident_list_[frame_id] = ResidentList::NONE;
+  }
+}
+
+// Pinned frames are few and were used recently, so they sit near the front; the walk from the back stops early.
+bool ARCReplacer::FindEvictable(const std::list<frame_id_t> &list, frame_id_t *frame_id) const {
+  for (auto iter = list.rbegin(); iter != list.rend(); ++iter) {
+    if (evictable_[*iter]) {
+      *frame_id = *iter;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ARCReplacer::PopGhost(GhostList *ghost) {
+  ghost->map_.erase(ghost->list_.back());
+  ghost->list_.pop_back();
+}
+
+}  // namespace bustub
@@ -11,7 +11,17 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/buffer_pool_manager_instance.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "common/macros.h"
@@ -20,11 +30,13 @@
 namespace bustub {
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager,
-                                                     LogManager *log_manager)
-    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, log_manager) {}
+                                                     LogManager *log_manager, ReplacerPolicy replacer_policy,
+                                                     HugePagePolicy huge_page_policy)
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, log_manager, replacer_policy, huge_page_policy) {}
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
-                                                     DiskManager *disk_manager, LogManager *log_manager)
+                                                     DiskManager *disk_manager, LogManager *log_manager,
+                                                     ReplacerPolicy replacer_policy, HugePagePolicy huge_page_policy)
     : pool_size_(pool_size),
       num_instances_(num_instances),
       instance_index_(instance_index),
@@ -36,89 +48,247 @@ BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t
       instance_index < num_instances,
       "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should just be 1.");
   // We allocate a consecutive memory space for the buffer pool.
-  pages_ = new Page[pool_size_];  // 这里就是bufferpool中存放数据页的地方
-  replacer_ = new LRUReplacer(pool_size);
+  frame_arena_ = new FrameArena(pool_size_, huge_page_policy);  // 这里就是bufferpool中存放数据页的地方
+  pages_ = new Page[pool_size_];
+  for (size_t i = 0; i < pool_size_; ++i) {
+    pages_[i].data_ = frame_arena_->GetFrameData(static_cast<frame_id_t>(i));
+  }
+  switch (replacer_policy) {
+    case ReplacerPolicy::CLOCK:
+      replacer_ = new ClockReplacer(pool_size);
+      break;
+    case ReplacerPolicy::LRU_K:
+      replacer_ = new LRUKReplacer(pool_size, LRUK_REPLACER_K, LRUK_CORRELATED_WINDOW);
+      break;
+    case ReplacerPolicy::ARC:
+      replacer_ = new ARCReplacer(pool_size);
+      break;
+    case ReplacerPolicy::LRU:
+    default:
+      replacer_ = new LRUReplacer(pool_size);
+      break;
+  }
 
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
     free_list_.push_back(static_cast<int>(i));
   }
+  prefetcher_ = new Prefetcher(this);
+
+  // 数据库重启后从分配表接着分配: 本实例的空闲id留着复用, 新id从最后一个在用的页之后开始
+  if (disk_manager_ != nullptr) {
+    std::vector<bool> allocated;
+    disk_manager_->GetAllocationMap(&allocated);
+    auto end = static_cast<page_id_t>(allocated.size());
+    page_id_t page_id = instance_index_;
+    for (; page_id < end; page_id += num_instances_) {
+      if (!allocated[page_id]) {
+        free_page_ids_.insert(page_id);
+      }
+    }
+    next_page_id_ = page_id;
+  }
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
+  warm_up_stop_ = true;
+  WaitForWarmUp();
+  StopBackgroundWriter();
+  // 预读线程可能还在往bufferpool里读页, 先停掉它
+  delete prefetcher_;
   delete[] pages_;
+  delete frame_arena_;
   delete replacer_;
+  delete compressed_cache_;
 }
 
 //  FlushPgImp should flush a page regardless of its pin status.
 bool BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) {
   // Make sure you call DiskManager::WritePage!
-  std::lock_guard<std::mutex> lock(latch_);
-  bool is_flushed = false;
-  // if (page_table_.count(page_id) != 0) {
-  //   Page *page_to_flush = &pages_[page_table_[page_id]];
-  //   disk_manager_->WritePage(page_id, page_to_flush->GetData());
-  //   page_to_flush->is_dirty_ = false;
-  //   is_flushed = true;
-  // }
-  auto iter = page_table_.find(page_id);
-  if (iter != page_table_.end()) {
-    Page *page_to_flush = &pages_[iter->second];
+  PageTableShard &shard = GetShard(page_id);
+  std::unique_lock<std::mutex> lock(shard.latch_);
+  auto iter = shard.page_table_.find(page_id);
+  while (iter != shard.page_table_.end() && pages_[iter->second].is_io_in_progress_) {
+    // 该页正在读入或写回，等它完成后重新查找
+    shard.io_cv_.wait(lock);
+    iter = shard.page_table_.find(page_id);
+  }
+  if (iter == shard.page_table_.end()) {
+    return false;
+  }
+
+  frame_id_t frame_id_to_flush = iter->second;
+  Page *page_to_flush = &pages_[frame_id_to_flush];
+  // Clear the dirty flag before writing, so an UnpinPage(dirty) racing with the write is not lost.
+  SetFrameState(&shard, page_to_flush, page_to_flush->pin_count_, false);
+  page_to_flush->is_io_in_progress_ = true;
+  lock.unlock();
+  {
+    DiskTimer timer(&shard.stats_.disk_write_ns_);
     disk_manager_->WritePage(page_id, page_to_flush->GetData());
-    page_to_flush->is_dirty_ = false;
-    is_flushed = true;
   }
-  return is_flushed;
+  lock.lock();
+  BufferPoolCounters::Bump(&shard.stats_.write_backs_);
+  FinishIo(&shard, frame_id_to_flush);
+  return true;
 }
 
 void BufferPoolManagerInstance::FlushAllPgsImp() {
-  std::lock_guard<std::mutex> lock(latch_);
+  // The latches are dropped for the writes, so take a snapshot of the dirty pages first.
+  std::vector<DirtyPage> dirty_pages;
+  CollectDirtyPages(&dirty_pages);
+  FlushDirtyPages(disk_manager_, &dirty_pages);
+}
+
+void BufferPoolManagerInstance::CollectDirtyPages(std::vector<DirtyPage> *dirty_pages) {
+  for (auto &shard : page_table_shards_) {
+    std::lock_guard<std::mutex> lock(shard.latch_);
+    for (auto &element : shard.page_table_) {
+      if (pages_[element.second].is_dirty_) {
+        dirty_pages->emplace_back(element.first, this);
+      }
+    }
+  }
+}
+
+bool BufferPoolManagerInstance::BeginFlush(page_id_t page_id, frame_id_t *frame_id) {
+  PageTableShard &shard = GetShard(page_id);
+  std::unique_lock<std::mutex> lock(shard.latch_);
+  auto iter = shard.page_table_.find(page_id);
+  while (iter != shard.page_table_.end() && pages_[iter->second].is_io_in_progress_) {
+    shard.io_cv_.wait(lock);
+    iter = shard.page_table_.find(page_id);
+  }
+  // A page evicted or cleaned after the snapshot has already been written back.
+  if (iter == shard.page_table_.end() || !pages_[iter->second].is_dirty_) {
+    return false;
+  }
+  *frame_id = iter->second;
+  SetFrameState(&shard, &pages_[*frame_id], pages_[*frame_id].pin_count_, false);
+  pages_[*frame_id].is_io_in_progress_ = true;
+  return true;
+}
+
+void BufferPoolManagerInstance::EndFlush(page_id_t page_id, frame_id_t frame_id) {
+  PageTableShard &shard = GetShard(page_id);
+  std::lock_guard<std::mutex> lock(shard.latch_);
+  FinishIo(&shard, frame_id);
+}
 
-  Page *page_to_flush;
-  for (auto &element : page_table_) {
-    page_to_flush = &pages_[element.second];
-    disk_manager_->WritePage(element.first, page_to_flush->GetData());
-    page_to_flush->is_dirty_ = false;  // 对比别人代码看出来的
+void BufferPoolManagerInstance::FlushDirtyPages(DiskManager *disk_manager, std::vector<DirtyPage> *dirty_pages) {
+  // 按page id排序, 相邻的页合并成一次写
+  std::sort(dirty_pages->begin(), dirty_pages->end());
+  std::vector<std::pair<DirtyPage, frame_id_t>> batch;
+  std::vector<const char *> run;
+  for (size_t begin = 0; begin < dirty_pages->size(); begin += FLUSH_BATCH_SIZE) {
+    size_t end = std::min(begin + FLUSH_BATCH_SIZE, dirty_pages->size());
+    batch.clear();
+    for (size_t i = begin; i < end; i++) {
+      frame_id_t frame_id;
+      if ((*dirty_pages)[i].second->BeginFlush((*dirty_pages)[i].first, &frame_id)) {
+        batch.emplace_back((*dirty_pages)[i], frame_id);
+      }
+    }
+    if (batch.empty()) {
+      continue;
+    }
+    {
+      // 每个合并写是一个异步请求, 整批一起提交, 设备队列里同时有多个写; 整批的时间记在它第一个页的shard上
+      std::vector<IoHandle> writes;
+      DiskTimer timer(&batch[0].first.second->GetShard(batch[0].first.first).stats_.disk_write_ns_);
+      for (size_t run_begin = 0; run_begin < batch.size(); run_begin += run.size()) {
+        run.clear();
+        page_id_t first_page_id = batch[run_begin].first.first;
+        // 合并写不跨segment, 每个segment是一个文件
+        for (size_t i = run_begin;
+             i < batch.size() && batch[i].first.first == first_page_id + static_cast<int>(run.size()) &&
+             (run.empty() || batch[i].first.first % disk_manager->GetSegmentPages() != 0);
+             i++) {
+          BufferPoolManagerInstance *bpm = batch[i].first.second;
+          run.push_back(bpm->pages_[batch[i].second].GetData());
+        }
+        BufferPoolCounters &stats = batch[run_begin].first.second->GetShard(first_page_id).stats_;
+        BufferPoolCounters::Bump(&stats.write_backs_, run.size());
+        writes.push_back(disk_manager->WritePagesAsync(first_page_id, run.data(), run.size()));
+      }
+      disk_manager->SubmitIo();
+      for (IoHandle &write : writes) {
+        write.Wait();
+      }
+    }
+    for (auto &flushed : batch) {
+      flushed.first.second->EndFlush(flushed.first.first, flushed.second);
+    }
   }
+  disk_manager->Sync();
 }
 
 // Creates a new page in the buffer pool. ,注意这是创建一个新的页,得立即写回磁盘!
-Page *BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) {
+Page *BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) { return NewPgImp(page_id, true); }
+
+Page *BufferPoolManagerInstance::NewPgImp(page_id_t *page_id, bool wait_for_frame) {
   // 0.   Make sure you call AllocatePage!
   // 1.   If all the pages in the buffer pool are pinned, return nullptr.
   // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
   // 3.   Update P's metadata, zero out memory and add P to the page table.
   // 4.   Set the page ID output parameter. Return a pointer to P.
-  // latch_.lock();
-  std::lock_guard<std::mutex> lock(latch_);
   // 1. 分配pageid
   // page_id_t page_id_just_allocated = AllocatePage(); //别在这里分配 ！！！ 否则在
   // ParallelBufferPoolManager的newpage测试中会有很大的pageid
+  // 查询中的pin记在它的配额上, 超出配额的pin不等待frame
+  PinQuota *quota = PinQuota::Current();
+  bool within_quota = quota != nullptr && quota->Charge();
   frame_id_t frame_id_to_place_new_page;
-  Page *new_page = nullptr;
-  // 2. 找一个空闲的frame
-  if (FindFramePageId(&frame_id_to_place_new_page)) {
-    // 3. 更新元数据并添加pagetable
-    new_page = &pages_[frame_id_to_place_new_page];
-    new_page->ResetMemory();
-    page_id_t page_id_just_allocated = AllocatePage();
-    new_page->page_id_ = page_id_just_allocated;
-    new_page->is_dirty_ = false;  // 最后要写回磁盘，所以改成为false
-    new_page->pin_count_++;
-    // 在pagetable中添加frame_id和page_id的映射
-    page_table_[page_id_just_allocated] = frame_id_to_place_new_page;
-    // repalcer pin这个页面
-    replacer_->Pin(frame_id_to_place_new_page);
-    // 4.
-    *page_id = page_id_just_allocated;
-    // 5.将新页面写回磁盘
-    disk_manager_->WritePage(page_id_just_allocated, new_page->GetData());
-  }
-  // latch_.unlock();
+  // 2. 找一个空闲的frame, 这个frame现在只属于本线程. A query within its quota waits for one rather than failing.
+  if (!AcquireFrame(&frame_id_to_place_new_page, wait_for_frame && within_quota)) {
+    if (quota != nullptr) {
+      quota->Release();
+    }
+    return nullptr;
+  }
+  // 3. 更新元数据并添加pagetable
+  Page *new_page = &pages_[frame_id_to_place_new_page];
+  new_page->ResetMemory();
+  // 复用的pageid可能还有一个过时的副本在bufferpool中(被过时的fetch读回来的), 先把它丢掉; 还被pin住的副本不能丢,
+  // 这个id先跳过, 等新页装好后再释放回去
+  std::vector<page_id_t> skipped_page_ids;
+  page_id_t page_id_just_allocated = AllocatePage();
+  PageTableShard *shard = &GetShard(page_id_just_allocated);
+  std::unique_lock<std::mutex> lock(shard->latch_);
+  while (!DropStalePage(shard, &lock, page_id_just_allocated)) {
+    lock.unlock();
+    skipped_page_ids.push_back(page_id_just_allocated);
+    page_id_just_allocated = AllocatePage();
+    shard = &GetShard(page_id_just_allocated);
+    lock = std::unique_lock<std::mutex>(shard->latch_);
+  }
+  new_page->page_id_ = page_id_just_allocated;
+  // 新页面不写回磁盘: 磁盘空间在AllocatePage时已预留, 没写过的页读出来就是全零
+  SetFrameState(shard, new_page, 1, false);
+  new_page->access_count_ = 1;
+  new_page->is_deallocated_ = false;
+  // 在pagetable中添加frame_id和page_id的映射
+  shard->page_table_[page_id_just_allocated] = frame_id_to_place_new_page;
+  replacer_->RecordLoad(frame_id_to_place_new_page, page_id_just_allocated);
+  lock.unlock();
+  for (page_id_t skipped_page_id : skipped_page_ids) {
+    DeallocatePage(skipped_page_id);
+  }
+  // 4.
+  *page_id = page_id_just_allocated;
+  if (quota != nullptr) {
+    quota->Track(page_id_just_allocated);
+  }
   return new_page;
 }
 
-Page *BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) {
+Page *BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) { return FetchPgInRingImp(page_id, nullptr, nullptr); }
+
+Page *BufferPoolManagerInstance::FetchPgInRingImp(page_id_t page_id, BufferRing *ring) {
+  return FetchPgInRingImp(page_id, ring, nullptr);
+}
+
+Page *BufferPoolManagerInstance::FetchPgInRingImp(page_id_t page_id, BufferRing *ring, bool *is_resident) {
   // 1.     Search the page table for the requested page (P).
   // 1.1    If P exists, pin it and return it immediately.
   // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
@@ -127,51 +297,512 @@ Page *BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) {
   // 3.     Delete R from the page table and
   // 4.     Insert P in pageTable
   // 5.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
-
-  // latch_.lock();
-  std::lock_guard<std::mutex> lock(latch_);
-  Page *fetched_page = nullptr;
+  PinQuota *quota = PinQuota::Current();
+  bool within_quota = quota != nullptr && quota->Charge();
+  PageTableShard &shard = GetShard(page_id);
+  std::unique_lock<std::mutex> lock(shard.latch_);
   frame_id_t frame_id_to_fetch;
-  // 1.search in the  pagetable
-  // if (page_table_.count(page_id) != 0) {
-  //   // 1.1 在bufferpool中存在相应的page
-  //   frame_id_to_fetch = page_table_[page_id];
-  //   fetched_page = &pages_[frame_id_to_fetch];
-  //   fetched_page->pin_count_++;         // pincount 加一
-  //   replacer_->Pin(frame_id_to_fetch);  // 通知replaceer,不要将这个frame考虑在lru算法的范围内
-  //   // latch_.unlock();
-  //   return &pages_[frame_id_to_fetch];
-  // }
-  auto iter = page_table_.find(page_id);
-  if (iter != page_table_.end()) {
-    // 1.1 在bufferpool中存在相应的page
-    frame_id_to_fetch = iter->second;
-    fetched_page = &pages_[frame_id_to_fetch];
-    fetched_page->pin_count_++;         // pincount 加一
-    replacer_->Pin(frame_id_to_fetch);  // 通知replaceer,不要将这个frame考虑在lru算法的范围内
-    // latch_.unlock();
-    return &pages_[frame_id_to_fetch];
-  }
-  // 1.2 bufferpool中不存在page,使用FindFramePageId辅助函数取得一个bufferpool中的空闲frameid
-  // 2和3步骤 在 辅助函数中完成
-  if (FindFramePageId(&frame_id_to_fetch)) {
-    // 4. 在pagetable中添加映射
-    page_table_[page_id] = frame_id_to_fetch;
-    // 5.更新Page的元数据
-    fetched_page = &pages_[frame_id_to_fetch];
-    fetched_page->ResetMemory();
-    fetched_page->page_id_ = page_id;
-    fetched_page->is_dirty_ = false;
-    fetched_page->pin_count_++;
-    replacer_->Pin(frame_id_to_fetch);
-    // 6. 将磁盘内容读到bufferpool中
-    disk_manager_->ReadPage(page_id, fetched_page->GetData());
+  BufferRing::Slot *ring_slot = nullptr;
+  // What the ring slot held when it was taken, i.e. the page to evict to recycle its frame.
+  BufferRing::Slot recyclable;
+  while (true) {
+    // 1.search in the  pagetable
+    auto iter = shard.page_table_.find(page_id);
+    if (iter != shard.page_table_.end()) {
+      // 1.1 在bufferpool中存在相应的page
+      frame_id_to_fetch = iter->second;
+      Page *fetched_page = &pages_[frame_id_to_fetch];
+      if (fetched_page->is_io_in_progress_) {
+        // 另一个线程正在读入这个页，或者它作为牺牲页正在写回; 等待完成后重新查找
+        BufferPoolCounters::Bump(&shard.stats_.pin_waits_);
+        shard.io_cv_.wait(lock);
+        continue;
+      }
+      if (is_resident != nullptr) {
+        // 预读不是一次访问, 已经在bufferpool中的页不去pin它
+        *is_resident = true;
+        if (quota != nullptr) {
+          quota->Release();
+        }
+        return nullptr;
+      }
+      // 通知replaceer,不要将这个frame考虑在lru算法的范围内. A frame that is already pinned is not in the replacer.
+      if (fetched_page->pin_count_ == 0) {
+        replacer_->Pin(frame_id_to_fetch);
+      }
+      SetFrameState(&shard, fetched_page, fetched_page->pin_count_ + 1, fetched_page->is_dirty_);
+      fetched_page->access_count_++;
+      BufferPoolCounters::Bump(&shard.stats_.hits_);
+      if (quota != nullptr) {
+        quota->Track(page_id);
+      }
+      return fetched_page;
+    }
+    // 1.2 bufferpool中不存在page,使用FindFramePageId辅助函数取得一个bufferpool中的空闲frameid
+    // 2和3步骤 在 辅助函数中完成. It takes other shard latches, so ours must be released first.
+    lock.unlock();
+    if (ring != nullptr && ring_slot == nullptr) {
+      ring_slot = NextRingSlot(ring, &recyclable);
+    }
+    // A scan recycles the frame of its ring if it still holds the page the ring read into it.
+    bool recycled = recyclable.page_id_ != INVALID_PAGE_ID && EvictFrame(recyclable.frame_id_, recyclable.page_id_);
+    if (recycled) {
+      frame_id_to_fetch = recyclable.frame_id_;
+      recyclable.page_id_ = INVALID_PAGE_ID;
+    } else if (!AcquireFrame(&frame_id_to_fetch, within_quota)) {
+      // 如果在bufferpool中的所有页都是被pin住了,表示失败,返回nullptr
+      if (quota != nullptr) {
+        quota->Release();
+      }
+      return nullptr;
+    }
+    lock.lock();
+    // Another thread may have loaded the page while we were looking for a frame.
+    if (shard.page_table_.count(page_id) == 0) {
+      break;
+    }
+    {
+      std::lock_guard<std::mutex> free_list_lock(free_list_latch_);
+      free_list_.push_back(frame_id_to_fetch);
+    }
+    frame_signal_->Notify();
   }
 
-  // 如果在bufferpool中的所有页都是被pin住了,表示失败,返回nullptr
+  if (ring_slot != nullptr) {
+    std::lock_guard<std::mutex> ring_lock(ring->latch_);
+    ring_slot->frame_id_ = frame_id_to_fetch;
+    ring_slot->page_id_ = page_id;
+  }
+  Page *fetched_page = LoadPage(&shard, &lock, page_id, frame_id_to_fetch);
+  if (quota != nullptr) {
+    quota->Track(page_id);
+  }
+  return fetched_page;
+}
+
+Page *BufferPoolManagerInstance::LoadPage(PageTableShard *shard, std::unique_lock<std::mutex> *lock, page_id_t page_id,
+                                          frame_id_t frame_id) {
+  // 4. 在pagetable中添加映射
+  shard->page_table_[page_id] = frame_id;
+  replacer_->RecordLoad(frame_id, page_id);
+  // 5.更新Page的元数据
+  Page *fetched_page = &pages_[frame_id];
+  fetched_page->page_id_ = page_id;
+  SetFrameState(shard, fetched_page, 1, false);
+  fetched_page->access_count_ = 1;
+  {
+    // 过时的fetch可能把已经释放的页读回来, 记下来, 最后一个pin释放时就把这个frame丢掉
+    std::lock_guard<std::mutex> free_page_ids_lock(free_page_ids_latch_);
+    fetched_page->is_deallocated_ = free_page_ids_.count(page_id) != 0;
+  }
+  BufferPoolCounters::Bump(&shard->stats_.misses_);
+  // 6. 将磁盘内容读到bufferpool中, 读的时候不持有latch, 其他线程对这个页的fetch会等待
+  fetched_page->is_io_in_progress_ = true;
+  lock->unlock();
+  fetched_page->ResetMemory();
+  if (compressed_cache_ == nullptr || !compressed_cache_->Lookup(page_id, fetched_page->GetData())) {
+    DiskTimer timer(&shard->stats_.disk_read_ns_);
+    disk_manager_->ReadPage(page_id, fetched_page->GetData());
+  }
+  lock->lock();
+  FinishIo(shard, frame_id);
   return fetched_page;
 }
 
+bool BufferPoolManagerInstance::DropStalePage(PageTableShard *shard, std::unique_lock<std::mutex> *lock,
+                                              page_id_t page_id) {
+  auto iter = shard->page_table_.find(page_id);
+  while (iter != shard->page_table_.end() && pages_[iter->second].is_io_in_progress_) {
+    shard->io_cv_.wait(*lock);
+    iter = shard->page_table_.find(page_id);
+  }
+  if (iter == shard->page_table_.end()) {
+    return true;
+  }
+  if (pages_[iter->second].pin_count_ != 0) {
+    return false;
+  }
+  DiscardFrame(shard, iter->second);
+  return true;
+}
+
+void BufferPoolManagerInstance::DiscardFrame(PageTableShard *shard, frame_id_t frame_id) {
+  // Same as DeletePgImp, the content of a deallocated page is not written back.
+  Page *page = &pages_[frame_id];
+  shard->page_table_.erase(page->page_id_);
+  replacer_->Remove(frame_id);
+  page->page_id_ = INVALID_PAGE_ID;
+  SetFrameState(shard, page, 0, false);
+  page->is_deallocated_ = false;
+  page->ResetMemory();
+  {
+    std::lock_guard<std::mutex> free_list_lock(free_list_latch_);
+    free_list_.push_back(frame_id);
+  }
+  frame_signal_->Notify();
+}
+
+bool BufferPoolManagerInstance::ReadAheadPgImp(page_id_t page_id, BufferRing *ring, next_page_id_fn next_page_id,
+                                               page_id_t *next) {
+  while (true) {
+    {
+      PageTableShard &shard = GetShard(page_id);
+      std::unique_lock<std::mutex> lock(shard.latch_);
+      auto iter = shard.page_table_.find(page_id);
+      while (iter != shard.page_table_.end() && pages_[iter->second].is_io_in_progress_) {
+        shard.io_cv_.wait(lock);
+        iter = shard.page_table_.find(page_id);
+      }
+      if (iter != shard.page_table_.end()) {
+        // 已经在bufferpool中: 不pin, 也不告诉replacer. The shard latch keeps the page resident while its link is read.
+        *next = next_page_id != nullptr ? next_page_id(&pages_[iter->second]) : INVALID_PAGE_ID;
+        return true;
+      }
+    }
+    // A miss: the replacer only sees the load, and the unpin that makes the frame evictable.
+    bool is_resident = false;
+    Page *page = FetchPgInRingImp(page_id, ring, &is_resident);
+    if (page != nullptr) {
+      *next = next_page_id != nullptr ? next_page_id(page) : INVALID_PAGE_ID;
+      UnpinPgImp(page_id, false);
+      return true;
+    }
+    if (!is_resident) {
+      // Every frame is pinned, reading ahead would only get in the way.
+      return false;
+    }
+    // Another thread read the page in meanwhile, read its link as above.
+  }
+}
+
+void BufferPoolManagerInstance::PrefetchPgImp(page_id_t page_id, size_t num_pages, next_page_id_fn next_page_id,
+                                              std::shared_ptr<BufferRing> ring) {
+  prefetcher_->Enqueue(page_id, num_pages, next_page_id, std::move(ring));
+}
+
+void BufferPoolManagerInstance::StartBackgroundWriter(const BackgroundWriterOptions &options) {
+  std::lock_guard<std::mutex> lock(bg_writer_latch_);
+  if (bg_writer_thread_ != nullptr) {
+    return;
+  }
+  bg_writer_options_ = options;
+  bg_writer_stop_ = false;
+  bg_writer_cleaning_ = false;
+  bg_writer_thread_ = new std::thread(&BufferPoolManagerInstance::RunBackgroundWriter, this);
+}
+
+void BufferPoolManagerInstance::StopBackgroundWriter() {
+  std::thread *bg_writer_thread;
+  {
+    std::lock_guard<std::mutex> lock(bg_writer_latch_);
+    bg_writer_stop_ = true;
+    bg_writer_thread = bg_writer_thread_;
+    bg_writer_thread_ = nullptr;
+  }
+  bg_writer_cv_.notify_all();
+  if (bg_writer_thread != nullptr) {
+    bg_writer_thread->join();
+    delete bg_writer_thread;
+  }
+}
+
+void BufferPoolManagerInstance::RunBackgroundWriter() {
+  std::unique_lock<std::mutex> lock(bg_writer_latch_);
+  size_t rounds = 0;
+  while (!bg_writer_cv_.wait_for(lock, bg_writer_options_.interval_, [this] { return bg_writer_stop_; })) {
+    lock.unlock();
+    CleanVictims();
+    rounds++;
+    if (!bg_writer_options_.resident_pages_file_.empty() && rounds % bg_writer_options_.dump_interval_rounds_ == 0) {
+      DumpResidentPages(bg_writer_options_.resident_pages_file_);
+    }
+    lock.lock();
+  }
+}
+
+size_t BufferPoolManagerInstance::CleanVictims() {
+  std::vector<frame_id_t> victims;
+  replacer_->PeekVictims(bg_writer_options_.high_watermark_, &victims);
+  // 先数一数接下来的牺牲页中有多少是干净的
+  size_t num_clean = 0;
+  std::vector<std::pair<frame_id_t, page_id_t>> dirty_victims;
+  for (frame_id_t frame_id : victims) {
+    page_id_t page_id = pages_[frame_id].GetPageId();
+    if (page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    PageTableShard &shard = GetShard(page_id);
+    std::lock_guard<std::mutex> lock(shard.latch_);
+    if (pages_[frame_id].IsDirty()) {
+      dirty_victims.emplace_back(frame_id, page_id);
+    } else {
+      num_clean++;
+    }
+  }
+  if (num_clean < bg_writer_options_.low_watermark_) {
+    bg_writer_cleaning_ = true;
+  }
+  if (num_clean >= bg_writer_options_.high_watermark_ || dirty_victims.empty()) {
+    bg_writer_cleaning_ = false;
+  }
+  if (!bg_writer_cleaning_) {
+    return 0;
+  }
+  std::vector<std::pair<frame_id_t, page_id_t>> cleaning;
+  std::vector<IoHandle> writes;
+  for (auto &victim : dirty_victims) {
+    if (num_clean >= bg_writer_options_.high_watermark_ || cleaning.size() >= bg_writer_options_.max_pages_per_round_) {
+      break;
+    }
+    if (BeginCleanFrame(victim.first, victim.second)) {
+      writes.push_back(disk_manager_->WritePageAsync(victim.second, pages_[victim.first].GetData()));
+      cleaning.push_back(victim);
+      num_clean++;
+    }
+  }
+  if (cleaning.empty()) {
+    return 0;
+  }
+  {
+    // 这一轮的写一起提交, 时间记在第一个页的shard上
+    DiskTimer timer(&GetShard(cleaning[0].second).stats_.disk_write_ns_);
+    disk_manager_->SubmitIo();
+    for (IoHandle &write : writes) {
+      write.Wait();
+    }
+  }
+  for (auto &cleaned : cleaning) {
+    EndCleanFrame(cleaned.first, cleaned.second);
+  }
+  return cleaning.size();
+}
+
+bool BufferPoolManagerInstance::BeginCleanFrame(frame_id_t frame_id, page_id_t page_id) {
+  Page *page_to_clean = &pages_[frame_id];
+  PageTableShard &shard = GetShard(page_id);
+  std::unique_lock<std::mutex> lock(shard.latch_);
+  auto iter = shard.page_table_.find(page_id);
+  if (iter == shard.page_table_.end() || iter->second != frame_id || page_to_clean->is_io_in_progress_ ||
+      page_to_clean->pin_count_ != 0 || !page_to_clean->is_dirty_) {
+    return false;
+  }
+  // Same as FlushPgImp: the dirty flag is cleared first, and the frame is marked so an evictor waits for the write.
+  SetFrameState(&shard, page_to_clean, 0, false);
+  page_to_clean->is_io_in_progress_ = true;
+  return true;
+}
+
+void BufferPoolManagerInstance::EndCleanFrame(frame_id_t frame_id, page_id_t page_id) {
+  PageTableShard &shard = GetShard(page_id);
+  std::lock_guard<std::mutex> lock(shard.latch_);
+  BufferPoolCounters::Bump(&shard.stats_.write_backs_);
+  FinishIo(&shard, frame_id);
+}
+
+void BufferPoolManagerInstance::EnableCompressedCache(size_t capacity_bytes) {
+  BUSTUB_ASSERT(compressed_cache_ == nullptr, "the compressed cache is already enabled");
+  compressed_cache_ = new CompressedPageCache(capacity_bytes);
+}
+
+CompressedPageCacheStats BufferPoolManagerInstance::GetCompressedCacheStats() {
+  return compressed_cache_ == nullptr ? CompressedPageCacheStats() : compressed_cache_->GetStats();
+}
+
+BufferPoolStats BufferPoolManagerInstance::GetStats() {
+  BufferPoolStats stats;
+  for (auto &shard : page_table_shards_) {
+    shard.stats_.AddTo(&stats);
+  }
+  return stats;
+}
+
+uint64_t BufferPoolManagerInstance::GetPageAccessCount(page_id_t page_id) {
+  PageTableShard &shard = GetShard(page_id);
+  std::lock_guard<std::mutex> lock(shard.latch_);
+  auto iter = shard.page_table_.find(page_id);
+  return iter == shard.page_table_.end() ? 0 : pages_[iter->second].access_count_;
+}
+
+void BufferPoolManagerInstance::DumpStats(std::ostream &os, size_t num_hot_pages) {
+  os << "instance " << instance_index_ << ": " << GetStats() << "\n";
+  if (compressed_cache_ != nullptr) {
+    CompressedPageCacheStats cache_stats = compressed_cache_->GetStats();
+    os << "  compressed cache: hits=" << cache_stats.hits_ << " lookups=" << cache_stats.lookups_
+       << " hit_ratio=" << cache_stats.HitRatio() << " compression_ratio=" << cache_stats.CompressionRatio()
+       << " size=" << compressed_cache_->GetSize() << "\n";
+  }
+  // (access count, page id) of every resident page, hottest first
+  std::vector<std::pair<uint64_t, page_id_t>> accesses;
+  for (auto &shard : page_table_shards_) {
+    std::lock_guard<std::mutex> lock(shard.latch_);
+    for (auto &element : shard.page_table_) {
+      accesses.emplace_back(pages_[element.second].access_count_, element.first);
+    }
+  }
+  num_hot_pages = std::min(num_hot_pages, accesses.size());
+  std::partial_sort(accesses.begin(), accesses.begin() + num_hot_pages, accesses.end(),
+                    std::greater<std::pair<uint64_t, page_id_t>>());
+  for (size_t i = 0; i < num_hot_pages; i++) {
+    os << "  page " << accesses[i].second << ": " << accesses[i].first << " accesses\n";
+  }
+}
+
+void BufferPoolManagerInstance::CollectResidentPages(std::vector<page_id_t> *page_ids) {
+  std::unordered_set<page_id_t> resident;
+  for (auto &shard : page_table_shards_) {
+    std::lock_guard<std::mutex> lock(shard.latch_);
+    for (auto &element : shard.page_table_) {
+      resident.insert(element.first);
+    }
+  }
+  // 先按replacer的牺牲顺序(最冷的在前), 剩下的是被pin住的页, 算作最热的
+  std::vector<frame_id_t> victims;
+  replacer_->PeekVictims(pool_size_, &victims);
+  for (frame_id_t frame_id : victims) {
+    page_id_t page_id = pages_[frame_id].GetPageId();
+    if (resident.erase(page_id) != 0) {
+      page_ids->push_back(page_id);
+    }
+  }
+  page_ids->insert(page_ids->end(), resident.begin(), resident.end());
+}
+
+bool BufferPoolManagerInstance::DumpResidentPages(const std::string &file_name) {
+  std::vector<page_id_t> page_ids;
+  CollectResidentPages(&page_ids);
+  return WritePageIds(file_name, page_ids);
+}
+
+bool BufferPoolManagerInstance::WritePageIds(const std::string &file_name, const std::vector<page_id_t> &page_ids) {
+  std::ostringstream out;
+  for (page_id_t page_id : page_ids) {
+    out << page_id << "\n";
+  }
+  std::string content = out.str();
+  std::string tmp_file_name = file_name + ".tmp";
+  int fd = open(tmp_file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  size_t written = 0;
+  while (written < content.size()) {
+    ssize_t n = write(fd, content.data() + written, content.size() - written);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      break;
+    }
+    written += n;
+  }
+  // 先让临时文件落盘再rename, 否则崩溃后可能看到rename过来的空文件
+  bool ok = written == content.size() && fsync(fd) == 0;
+  ok = close(fd) == 0 && ok;
+  if (!ok) {
+    std::remove(tmp_file_name.c_str());
+    return false;
+  }
+  return std::rename(tmp_file_name.c_str(), file_name.c_str()) == 0;
+}
+
+bool BufferPoolManagerInstance::ReadPageIds(const std::string &file_name, std::vector<page_id_t> *page_ids) {
+  std::ifstream in(file_name);
+  if (!in.is_open()) {
+    return false;
+  }
+  page_id_t page_id;
+  while (in >> page_id) {
+    page_ids->push_back(page_id);
+  }
+  return true;
+}
+
+size_t BufferPoolManagerInstance::WarmUp(const std::string &file_name, bool in_background) {
+  std::vector<page_id_t> page_ids;
+  if (!ReadPageIds(file_name, &page_ids)) {
+    return 0;
+  }
+  PlanWarmUp(&page_ids);
+  if (!in_background) {
+    return RunWarmUp(page_ids);
+  }
+  WaitForWarmUp();
+  size_t num_pages = page_ids.size();
+  std::lock_guard<std::mutex> lock(warm_up_latch_);
+  warm_up_thread_ = new std::thread([this, page_ids = std::move(page_ids)] { RunWarmUp(page_ids); });
+  return num_pages;
+}
+
+void BufferPoolManagerInstance::WaitForWarmUp() {
+  std::thread *warm_up_thread;
+  {
+    std::lock_guard<std::mutex> lock(warm_up_latch_);
+    warm_up_thread = warm_up_thread_;
+    warm_up_thread_ = nullptr;
+  }
+  if (warm_up_thread != nullptr) {
+    warm_up_thread->join();
+    delete warm_up_thread;
+  }
+}
+
+void BufferPoolManagerInstance::PlanWarmUp(std::vector<page_id_t> *page_ids) {
+  // 从最热的一端往回取, 只保留属于本实例且仍在使用的页, 最多装满bufferpool
+  std::vector<page_id_t> planned;
+  std::unordered_set<page_id_t> seen;
+  for (auto iter = page_ids->rbegin(); iter != page_ids->rend() && planned.size() < pool_size_; ++iter) {
+    page_id_t page_id = *iter;
+    if (page_id < 0 || static_cast<uint32_t>(page_id) % num_instances_ != instance_index_ ||
+        !disk_manager_->IsPageAllocated(page_id) || !seen.insert(page_id).second) {
+      continue;
+    }
+    planned.push_back(page_id);
+  }
+  std::reverse(planned.begin(), planned.end());
+  // Batches keep the coldest-first order between them, the page id order within them.
+  for (size_t begin = 0; begin < planned.size(); begin += WARM_UP_BATCH_SIZE) {
+    size_t end = std::min(begin + WARM_UP_BATCH_SIZE, planned.size());
+    std::sort(planned.begin() + begin, planned.begin() + end);
+  }
+  *page_ids = std::move(planned);
+}
+
+size_t BufferPoolManagerInstance::RunWarmUp(const std::vector<page_id_t> &page_ids) {
+  size_t num_read = 0;
+  for (page_id_t page_id : page_ids) {
+    if (warm_up_stop_) {
+      break;
+    }
+    frame_id_t frame_id;
+    {
+      // Traffic comes first: only free frames are used, a warm-up page never evicts a page.
+      std::lock_guard<std::mutex> free_list_lock(free_list_latch_);
+      if (free_list_.empty()) {
+        break;
+      }
+      frame_id = free_list_.front();
+      free_list_.pop_front();
+    }
+    PageTableShard &shard = GetShard(page_id);
+    std::unique_lock<std::mutex> lock(shard.latch_);
+    if (shard.page_table_.count(page_id) != 0) {
+      // 查询已经把这个页读进来了, frame还回去
+      lock.unlock();
+      {
+        std::lock_guard<std::mutex> free_list_lock(free_list_latch_);
+        free_list_.push_back(frame_id);
+      }
+      frame_signal_->Notify();
+      continue;
+    }
+    LoadPage(&shard, &lock, page_id, frame_id);
+    lock.unlock();
+    UnpinPgImp(page_id, false);
+    num_read++;
+  }
+  return num_read;
+}
+
 // 把bufferpool中的page移出
 bool BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) {
   // 0.   Make sure you call DeallocatePage!
@@ -179,15 +810,17 @@ bool BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) {
   // 1.   If P does not exist, return true.
   // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
-  std::lock_guard<std::mutex> lock(latch_);
-  // if (page_table_.count(page_id) == 0) {
-  //   // latch_.unlock();
-  //   return true;
-  // }
-  // frame_id_t frame_id_to_delete = page_table_[page_id];
-  // Page *page_to_delete = &pages_[frame_id_to_delete];
-  auto iter = page_table_.find(page_id);
-  if (iter == page_table_.end()) {
+  PageTableShard &shard = GetShard(page_id);
+  std::unique_lock<std::mutex> lock(shard.latch_);
+  auto iter = shard.page_table_.find(page_id);
+  while (iter != shard.page_table_.end() && pages_[iter->second].is_io_in_progress_) {
+    shard.io_cv_.wait(lock);
+    iter = shard.page_table_.find(page_id);
+  }
+  if (iter == shard.page_table_.end()) {
+    // 不在bufferpool中, 但可能在磁盘上
+    lock.unlock();
+    DeallocatePage(page_id);
     return true;
   }
 
@@ -199,18 +832,19 @@ bool BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) {
     return false;
   }
 
-  if (page_to_delete->IsDirty()) {
-    disk_manager_->WritePage(page_to_delete->page_id_, page_to_delete->data_);
-  }
-
-  page_table_.erase(page_id);
-  replacer_->Pin(frame_id_to_delete);  // 让replacer不要再管理这个被释放的页了
-  page_to_delete->ResetMemory();
+  // The page is going away, so there is no point in writing its content back even if it is dirty.
+  shard.page_table_.erase(iter);
+  replacer_->Remove(frame_id_to_delete);  // 让replacer不要再管理这个被释放的页了
   page_to_delete->page_id_ = INVALID_PAGE_ID;
-  page_to_delete->is_dirty_ = false;
-  page_to_delete->pin_count_ = 0;
+  SetFrameState(&shard, page_to_delete, 0, false);
+  lock.unlock();
 
-  free_list_.push_back(frame_id_to_delete);
+  page_to_delete->ResetMemory();
+  {
+    std::lock_guard<std::mutex> free_list_lock(free_list_latch_);
+    free_list_.push_back(frame_id_to_delete);
+  }
+  DeallocatePage(page_id);
 
   return true;
 }
@@ -218,15 +852,11 @@ bool BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) {
 // 这个函数的调用场景：如果本线程已经完成了对这个页的操作，unpin操作，isdirty表示，在本线程pin住这个页期间，有没有对它作写操作
 // 这里强调本线程 ！！ 为什么？ 看看设置 is_dirty的逻辑。
 bool BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) {
-  std::lock_guard<std::mutex> lock(latch_);
-  // if (page_table_.count(page_id) == 0) {
-  //   return false;
-  // }
-  // frame_id_t frame_id_unpin = page_table_[page_id];
-  // Page *page_to_unpin = &pages_[frame_id_unpin];
-
-  auto iter = page_table_.find(page_id);
-  if (iter == page_table_.end()) {
+  PageTableShard &shard = GetShard(page_id);
+  std::lock_guard<std::mutex> lock(shard.latch_);
+
+  auto iter = shard.page_table_.find(page_id);
+  if (iter == shard.page_table_.end()) {
     return false;
   }
   frame_id_t frame_id_unpin = iter->second;
@@ -236,30 +866,59 @@ bool BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) {
     return false;
   }
 
-  if (is_dirty) {
-    //这里得判断
-    // 如果本线程对这个页面做了写操作，那么里所应当得设置为脏
-    // 如果本线程没有写这个页面什么都不要做！ 因为可能其他线程写了这个页！
-    page_to_unpin->is_dirty_ = true;
-  }
-
-  page_to_unpin->pin_count_ -= 1;
-  if (page_to_unpin->pin_count_ == 0) {
+  //这里得判断
+  // 如果本线程对这个页面做了写操作，那么里所应当得设置为脏
+  // 如果本线程没有写这个页面什么都不要做！ 因为可能其他线程写了这个页！
+  SetFrameState(&shard, page_to_unpin, page_to_unpin->pin_count_ - 1, page_to_unpin->is_dirty_ || is_dirty);
+  if (page_to_unpin->pin_count_ == 0 && page_to_unpin->is_deallocated_) {
+    // 过时的fetch读回来的已释放的页, 没人再用了, 直接丢掉. Its id cannot have been handed out again meanwhile: NewPage
+    // skips ids whose stale copy is pinned.
+    DiscardFrame(&shard, frame_id_unpin);
+  } else if (page_to_unpin->pin_count_ == 0) {
     // 如果pincount为0，那么通知replacer管理它
     replacer_->Unpin(frame_id_unpin);
+    frame_signal_->Notify();
+  }
+  // 只有查询里pin的页才还给配额
+  PinQuota *quota = PinQuota::Current();
+  if (quota != nullptr) {
+    quota->ReleasePage(page_id);
   }
-  // latch_.unlock();
   return true;
 }
 
 // 仅仅是返回pageid，如果有多个bufferpool实例，相当于用hash的方式将page分散在各个bufferpool中
 page_id_t BufferPoolManagerInstance::AllocatePage() {
-  const page_id_t next_page_id = next_page_id_;
-  next_page_id_ += num_instances_;
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  {
+    // 优先复用最小的已释放页, 文件保持紧凑, 也保持局部性
+    std::lock_guard<std::mutex> lock(free_page_ids_latch_);
+    if (!free_page_ids_.empty()) {
+      next_page_id = *free_page_ids_.begin();
+      free_page_ids_.erase(free_page_ids_.begin());
+    }
+  }
+  if (next_page_id == INVALID_PAGE_ID) {
+    next_page_id = next_page_id_.fetch_add(num_instances_);
+  }
   ValidatePageId(next_page_id);
+  disk_manager_->AllocatePage(next_page_id);
   return next_page_id;
 }
 
+void BufferPoolManagerInstance::DeallocatePage(page_id_t page_id) {
+  if (page_id < 0 || page_id >= next_page_id_) {
+    // never handed out by this instance
+    return;
+  }
+  if (compressed_cache_ != nullptr) {
+    compressed_cache_->Erase(page_id);
+  }
+  disk_manager_->DeallocatePage(page_id);
+  std::lock_guard<std::mutex> lock(free_page_ids_latch_);
+  free_page_ids_.insert(page_id);
+}
+
 void BufferPoolManagerInstance::ValidatePageId(const page_id_t page_id) const {
   assert(page_id % num_instances_ == instance_index_);  // allocated pages mod back to this BPI
 }
@@ -267,38 +926,181 @@ void BufferPoolManagerInstance::ValidatePageId(const page_id_t page_id) const {
 // 辅助函数,在freeList或replacer中返回一个空闲的frame_id
 // 1. 在freelist中找空闲frame_id
 // 2. 如果空闲链表为空，则使用 replacer 牺牲一个页
-// 2.1 检查该页是否isDirty，如果是则调用disk_manager->WriteData()将数据写回，并重置pincount
+// 2.1 检查该页是否isDirty，如果是则在不持有latch的情况下将数据写回
 // 3 在pagetable中删除对应的映射关系
 bool BufferPoolManagerInstance::FindFramePageId(frame_id_t *frame_page_id) {
-  // 这里不能再加锁了! 否则两个线程对一把锁加两次锁,容易死锁
-  if (!free_list_.empty()) {
-    // 空闲链表中有东西,直接返回true
-    *frame_page_id = free_list_.front();
-    free_list_.pop_front();
-    return true;
+  {
+    std::lock_guard<std::mutex> free_list_lock(free_list_latch_);
+    if (!free_list_.empty()) {
+      // 空闲链表中有东西,直接返回true
+      *frame_page_id = free_list_.front();
+      free_list_.pop_front();
+      return true;
+    }
+  }
+
+  while (true) {
+    // 在lru中牺牲一个页
+    if (!replacer_->Victim(frame_page_id)) {
+      // 说明所有页都是被pin住的，不能移除
+      return false;
+    }
+    // 要被牺牲的页面. Between Victim() and taking the shard latch, a concurrent hit may pin the page (and an unpin may
+    // hand the frame to the replacer again), or the page may be deleted. EvictFrame re-validates under the latch.
+    // 或得牺牲页面的pageid
+    page_id_t page_id_to_victim = pages_[*frame_page_id].GetPageId();
+    if (page_id_to_victim != INVALID_PAGE_ID && EvictFrame(*frame_page_id, page_id_to_victim)) {
+      return true;
+    }
+  }
+}
+
+bool BufferPoolManagerInstance::AcquireFrame(frame_id_t *frame_page_id, bool wait_for_frame) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(FRAME_WAIT_TIMEOUT_MS);
+  while (true) {
+    if (FindFramePageId(frame_page_id)) {
+      return true;
+    }
+    if (!wait_for_frame) {
+      return false;
+    }
+    // 先登记为等待者再找一次: 在这之后释放的frame, 要么被这次查找看到, 要么会通知到我们
+    uint64_t epoch = frame_signal_->AddWaiter();
+    if (FindFramePageId(frame_page_id)) {
+      frame_signal_->RemoveWaiter();
+      return true;
+    }
+    if (!frame_signal_->WaitForRelease(epoch, deadline)) {
+      return false;
+    }
   }
+}
+
+uint64_t FrameReleaseSignal::AddWaiter() {
+  num_waiters_.fetch_add(1);
+  std::lock_guard<std::mutex> lock(latch_);
+  return epoch_;
+}
+
+void FrameReleaseSignal::RemoveWaiter() { num_waiters_.fetch_sub(1); }
 
-  // 在lru中牺牲一个页
-  if (!replacer_->Victim(frame_page_id)) {
-    // 说明所有页都是被pin住的，不能移除
+void FrameReleaseSignal::Notify() {
+  // 没有等待者时只读一次num_waiters_, unpin不去写所有实例共享的变量
+  if (num_waiters_.load() == 0) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    epoch_++;
+  }
+  cv_.notify_all();
+}
+
+bool FrameReleaseSignal::WaitForRelease(uint64_t epoch, std::chrono::steady_clock::time_point deadline) {
+  std::unique_lock<std::mutex> lock(latch_);
+  bool released = cv_.wait_until(lock, deadline, [&] { return epoch_ != epoch; });
+  lock.unlock();
+  RemoveWaiter();
+  return released;
+}
+
+bool BufferPoolManagerInstance::EvictFrame(frame_id_t frame_id, page_id_t page_id) {
+  Page *page_to_victim = &pages_[frame_id];
+  PageTableShard &shard = GetShard(page_id);
+  std::unique_lock<std::mutex> lock(shard.latch_);
+  auto iter = shard.page_table_.find(page_id);
+  while (iter != shard.page_table_.end() && iter->second == frame_id && page_to_victim->is_io_in_progress_) {
+    // The page is being flushed by FlushPgImp, or written back by another evictor.
+    shard.io_cv_.wait(lock);
+    iter = shard.page_table_.find(page_id);
+  }
+  if (iter == shard.page_table_.end() || iter->second != frame_id) {
+    // The frame changed hands, its new owner takes care of it.
     return false;
   }
-  // 要被牺牲的页面
-  Page *page_to_victim = &pages_[*frame_page_id];
-  // 或得牺牲页面的pageid
-  page_id_t page_id_to_victim = page_to_victim->GetPageId();
+  if (page_to_victim->pin_count_ != 0) {
+    // Pinned by a concurrent hit, which already took the frame out of the replacer.
+    return false;
+  }
+  // Hand the evicted page id to the replacer. This also drops a stale entry it may have been given since Victim().
+  replacer_->RecordEviction(frame_id, page_id);
 
-  // 检查lru返回的那个页面的dirty标志,重置pincount
-  // 好像没有必要reset pincount, 因为lru中维护的都是没有被pin住的frame_id
-  if (page_to_victim->IsDirty()) {
-    // 脏页,将它保存到磁盘上
-    disk_manager_->WritePage(page_id_to_victim, page_to_victim->GetData());  // 写入到磁盘
-    page_to_victim->pin_count_ = 0;
+  // 检查lru返回的那个页面的dirty标志
+  bool is_dirty = page_to_victim->IsDirty();
+  if (is_dirty || compressed_cache_ != nullptr) {
+    // 脏页,将它保存到磁盘上, 然后放进压缩缓存. The page stays in the page table meanwhile, so a concurrent fetch of it
+    // waits instead of reading a stale copy from disk, or racing the compressed copy into the cache.
+    page_to_victim->is_io_in_progress_ = true;
+    lock.unlock();
+    if (is_dirty) {
+      DiskTimer timer(&shard.stats_.disk_write_ns_);
+      disk_manager_->WritePage(page_id, page_to_victim->GetData());  // 写入到磁盘
+    }
+    if (compressed_cache_ != nullptr) {
+      compressed_cache_->Insert(page_id, page_to_victim->GetData());
+    }
+    lock.lock();
+    if (is_dirty) {
+      SetFrameState(&shard, page_to_victim, 0, false);
+      BufferPoolCounters::Bump(&shard.stats_.write_backs_);
+    }
+    FinishIo(&shard, frame_id);
   }
 
   // 删除pagetable的映射
-  page_table_.erase(page_id_to_victim);
+  shard.page_table_.erase(page_id);
+  page_to_victim->page_id_ = INVALID_PAGE_ID;
+  BufferPoolCounters::Bump(&shard.stats_.evictions_);
   return true;
 }
 
-}  // namespace bustub
\ No newline at end of file
+BufferRing::Slot *BufferPoolManagerInstance::NextRingSlot(BufferRing *ring, BufferRing::Slot *content) {
+  std::lock_guard<std::mutex> ring_lock(ring->latch_);
+  BufferRing::InstanceRing &instance_ring = ring->instance_rings_[this];
+  if (instance_ring.slots_.empty()) {
+    // Every instance of a parallel BPM recycles its share of the ring.
+    instance_ring.slots_.resize(std::max<size_t>((ring->GetSize() + num_instances_ - 1) / num_instances_, 1));
+  }
+  BufferRing::Slot *slot = &instance_ring.slots_[instance_ring.next_];
+  instance_ring.next_ = (instance_ring.next_ + 1) % instance_ring.slots_.size();
+  *content = *slot;
+  return slot;
+}
+
+void BufferPoolManagerInstance::SetFrameState(PageTableShard *shard, Page *page, int pin_count, bool is_dirty) {
+  bool was_unpinned = page->pin_count_ == 0;
+  bool was_clean_unpinned = was_unpinned && !page->is_dirty_;
+  page->pin_count_ = pin_count;
+  page->is_dirty_ = is_dirty;
+  bool is_unpinned = pin_count == 0;
+  bool is_clean_unpinned = is_unpinned && !is_dirty;
+  if (was_unpinned != is_unpinned) {
+    shard->unpinned_frames_delta_.fetch_add(is_unpinned ? 1 : -1, std::memory_order_relaxed);
+  }
+  if (was_clean_unpinned != is_clean_unpinned) {
+    shard->clean_unpinned_frames_delta_.fetch_add(is_clean_unpinned ? 1 : -1, std::memory_order_relaxed);
+  }
+}
+
+size_t BufferPoolManagerInstance::GetNumUnpinnedFrames() {
+  int64_t num_frames = pool_size_;
+  for (auto &shard : page_table_shards_) {
+    num_frames += shard.unpinned_frames_delta_.load(std::memory_order_relaxed);
+  }
+  return std::max<int64_t>(num_frames, 0);
+}
+
+size_t BufferPoolManagerInstance::GetNumCleanUnpinnedFrames() {
+  int64_t num_frames = pool_size_;
+  for (auto &shard : page_table_shards_) {
+    num_frames += shard.clean_unpinned_frames_delta_.load(std::memory_order_relaxed);
+  }
+  return std::max<int64_t>(num_frames, 0);
+}
+
+void BufferPoolManagerInstance::FinishIo(PageTableShard *shard, frame_id_t frame_id) {
+  pages_[frame_id].is_io_in_progress_ = false;
+  shard->io_cv_.notify_all();
+}
+
+}  // namespace bustub
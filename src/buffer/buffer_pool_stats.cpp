@@ -0,0 +1,29 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.cpp
+//
+// Identification: src/buffer/buffer_pool_stats.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_stats.h"
+
+#include <iomanip>
+#include <sstream>
+
+namespace bustub {
+
+std::string BufferPoolStats::ToString() const {
+  std::stringstream os;
+  os << "hits=" << hits_ << " misses=" << misses_ << " hit_ratio=" << std::fixed << std::setprecision(4)
+     << HitRatio() << " evictions=" << evictions_ << " write_backs=" << write_backs_
+     << " pin_waits=" << pin_waits_ << " disk_read_ms=" << std::setprecision(3) << disk_read_ns_ / 1e6
+     << " disk_write_ms=" << disk_write_ns_ / 1e6;
+  return os.str();
+}
+
+}  // namespace bustub
@@ -14,16 +14,69 @@
 
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages)
+    : num_pages_(num_pages), in_replacer_(num_pages), ref_bits_(num_pages) {}
 
 ClockReplacer::~ClockReplacer() = default;
 
-bool ClockReplacer::Victim(frame_id_t *frame_id) { return false; }
+bool ClockReplacer::Victim(frame_id_t *frame_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (size_ == 0) {
+    return false;
+  }
+  // Nothing changes under the latch, so a frame is in the replacer: the first turn clears the reference bits it
+  // passes, the second turn at the latest comes across that frame again.
+  while (true) {
+    size_t frame = clock_hand_;
+    clock_hand_ = (clock_hand_ + 1) % num_pages_;
+    if (!in_replacer_[frame]) {
+      continue;
+    }
+    if (ref_bits_[frame]) {
+      // Second chance.
+      ref_bits_[frame] = false;
+      continue;
+    }
+    in_replacer_[frame] = false;
+    size_--;
+    *frame_id = static_cast<frame_id_t>(frame);
+    return true;
+  }
+}
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+void ClockReplacer::Pin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (in_replacer_[frame_id]) {
+    in_replacer_[frame_id] = false;
+    size_--;
+  }
+}
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+void ClockReplacer::Unpin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+  ref_bits_[frame_id] = true;
+  if (!in_replacer_[frame_id]) {
+    in_replacer_[frame_id] = true;
+    size_++;
+  }
+}
 
-size_t ClockReplacer::Size() { return 0; }
+// The hand evicts the frames whose reference bit is clear on its way, the others only on its next turn.
+void ClockReplacer::PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) {
+  std::lock_guard<std::mutex> lock(latch_);
+  for (bool referenced : {false, true}) {
+    for (size_t step = 0; step < num_pages_ && frame_ids->size() < max_frames; step++) {
+      size_t frame = (clock_hand_ + step) % num_pages_;
+      if (in_replacer_[frame] && ref_bits_[frame] == referenced) {
+        frame_ids->push_back(static_cast<frame_id_t>(frame));
+      }
+    }
+  }
+}
+
+size_t ClockReplacer::Size() {
+  std::lock_guard<std::mutex> lock(latch_);
+  return size_;
+}
 
 }  // namespace bustub
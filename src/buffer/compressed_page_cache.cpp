@@ -0,0 +1,161 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.cpp
+//
+// Identification: src/buffer/compressed_page_cache.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/compressed_page_cache.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace bustub {
+
+namespace {
+// 编码: 控制字节c < 0x80 表示后面跟着c+1个原样字节; c >= 0x80 表示下一个字节重复(c & 0x7f) + MIN_RUN次
+constexpr size_t MIN_RUN = 3;
+constexpr size_t MAX_LITERAL = 0x80;
+constexpr size_t MAX_RUN = 0x7f + MIN_RUN;
+
+/** Write literal runs for data[begin, end) at out, and return where the output ends. */
+char *EmitLiterals(const char *data, size_t begin, size_t end, char *out) {
+  while (begin < end) {
+    size_t length = std::min(end - begin, MAX_LITERAL);
+    *out++ = static_cast<char>(length - 1);
+    memcpy(out, data + begin, length);
+    out += length;
+    begin += length;
+  }
+  return out;
+}
+}  // namespace
+
+CompressedPageCache::CompressedPageCache(size_t capacity_bytes) : capacity_bytes_(capacity_bytes) {}
+
+bool CompressedPageCache::Compress(const char *data, std::vector<char> *compressed) {
+  // Worst case: one control byte per MAX_LITERAL bytes. Anything longer than PAGE_SIZE is given up on anyway.
+  char buffer[PAGE_SIZE + PAGE_SIZE / MAX_LITERAL + 2];
+  char *out = buffer;
+  size_t literal_begin = 0;
+  size_t i = 0;
+  while (i < PAGE_SIZE) {
+    size_t run = 1;
+    while (i + run < PAGE_SIZE && run < MAX_RUN && data[i + run] == data[i]) {
+      run++;
+    }
+    if (run < MIN_RUN) {
+      i++;
+      continue;
+    }
+    out = EmitLiterals(data, literal_begin, i, out);
+    *out++ = static_cast<char>(0x80 | (run - MIN_RUN));
+    *out++ = data[i];
+    i += run;
+    literal_begin = i;
+    if (out - buffer >= PAGE_SIZE) {
+      return false;
+    }
+  }
+  out = EmitLiterals(data, literal_begin, PAGE_SIZE, out);
+  if (out - buffer >= PAGE_SIZE) {
+    return false;
+  }
+  compressed->assign(buffer, out);
+  return true;
+}
+
+bool CompressedPageCache::Decompress(const std::vector<char> &compressed, char *data) {
+  size_t out = 0;
+  size_t in = 0;
+  while (in < compressed.size()) {
+    auto control = static_cast<unsigned char>(compressed[in++]);
+    if (control < 0x80) {
+      size_t length = control + 1;
+      if (in + length > compressed.size() || out + length > PAGE_SIZE) {
+        return false;
+      }
+      memcpy(data + out, compressed.data() + in, length);
+      in += length;
+      out += length;
+    } else {
+      size_t length = (control & 0x7f) + MIN_RUN;
+      if (in >= compressed.size() || out + length > PAGE_SIZE) {
+        return false;
+      }
+      memset(data + out, compressed[in++], length);
+      out += length;
+    }
+  }
+  return out == PAGE_SIZE;
+}
+
+void CompressedPageCache::Insert(page_id_t page_id, const char *data) {
+  std::vector<char> compressed;
+  bool compressible = Compress(data, &compressed);
+  std::lock_guard<std::mutex> lock(latch_);
+  auto iter = entries_.find(page_id);
+  if (iter != entries_.end()) {
+    EraseEntry(iter);
+  }
+  if (!compressible || compressed.size() > capacity_bytes_) {
+    stats_.rejects_++;
+    return;
+  }
+  while (size_bytes_ + compressed.size() > capacity_bytes_) {
+    EraseEntry(entries_.find(lru_list_.back()));
+    stats_.evictions_++;
+  }
+  stats_.inserts_++;
+  stats_.uncompressed_bytes_ += PAGE_SIZE;
+  stats_.compressed_bytes_ += compressed.size();
+  size_bytes_ += compressed.size();
+  lru_list_.push_front(page_id);
+  entries_[page_id] = {std::move(compressed), lru_list_.begin()};
+}
+
+bool CompressedPageCache::Lookup(page_id_t page_id, char *data) {
+  std::lock_guard<std::mutex> lock(latch_);
+  stats_.lookups_++;
+  auto iter = entries_.find(page_id);
+  if (iter == entries_.end()) {
+    return false;
+  }
+  bool found = Decompress(iter->second.compressed_, data);
+  EraseEntry(iter);
+  if (found) {
+    stats_.hits_++;
+  }
+  return found;
+}
+
+void CompressedPageCache::Erase(page_id_t page_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+  auto iter = entries_.find(page_id);
+  if (iter != entries_.end()) {
+    EraseEntry(iter);
+  }
+}
+
+size_t CompressedPageCache::GetSize() {
+  std::lock_guard<std::mutex> lock(latch_);
+  return size_bytes_;
+}
+
+CompressedPageCacheStats CompressedPageCache::GetStats() {
+  std::lock_guard<std::mutex> lock(latch_);
+  return stats_;
+}
+
+void CompressedPageCache::EraseEntry(std::unordered_map<page_id_t, Entry>::iterator iter) {
+  size_bytes_ -= iter->second.compressed_.size();
+  lru_list_.erase(iter->second.lru_iter_);
+  entries_.erase(iter);
+}
+
+}  // namespace bustub
@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+size_t RoundUp(size_t size, size_t alignment) { return (size + alignment - 1) / alignment * alignment; }
+}  // namespace
+
+FrameArena::FrameArena(size_t num_frames, HugePagePolicy policy) : policy_(policy) {
+  size_t size = std::max<size_t>(num_frames, 1) * PAGE_SIZE;
+#ifdef MAP_HUGETLB
+  if (policy_ == HugePagePolicy::EXPLICIT) {
+    size_t huge_size = RoundUp(size, HUGE_PAGE_SIZE);
+    void *mapping = mmap(nullptr, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (mapping != MAP_FAILED) {
+      mapping_ = mapping;
+      mapping_size_ = huge_size;
+      data_ = static_cast<char *>(mapping);
+      return;
+    }
+  }
+#endif
+  // 没有预留的大页(或者不支持)时退回到透明大页
+  if (policy_ == HugePagePolicy::EXPLICIT) {
+    policy_ = HugePagePolicy::TRANSPARENT;
+  }
+  MapRegular(size, policy_ == HugePagePolicy::TRANSPARENT);
+}
+
+FrameArena::~FrameArena() { munmap(mapping_, mapping_size_); }
+
+void FrameArena::MapRegular(size_t size, bool transparent_huge_pages) {
+  // The kernel only backs huge page aligned ranges with huge pages, so map one more to align the start.
+  mapping_size_ = transparent_huge_pages ? RoundUp(size, HUGE_PAGE_SIZE) + HUGE_PAGE_SIZE : size;
+  void *mapping = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapping == MAP_FAILED) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "can't map buffer pool frames");
+  }
+  mapping_ = mapping;
+  data_ = static_cast<char *>(mapping);
+  if (transparent_huge_pages) {
+    data_ = reinterpret_cast<char *>(RoundUp(reinterpret_cast<uintptr_t>(mapping), HUGE_PAGE_SIZE));
+#ifdef MADV_HUGEPAGE
+    // Only advice: without THP support the region stays backed by regular pages.
+    madvise(data_, RoundUp(size, HUGE_PAGE_SIZE), MADV_HUGEPAGE);
+#endif
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.cpp
+//
+// Identification: src/buffer/lru_k_replacer.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/lru_k_replacer.h"
+
+namespace bustub {
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k, size_t correlated_window)
+    : k_(k),
+      correlated_window_(correlated_window),
+      history_(num_pages * k),
+      history_size_(num_pages),
+      last_access_(num_pages),
+      in_replacer_(num_pages) {}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (evictable_.empty()) {
+    return false;
+  }
+  *frame_id = std::get<2>(*evictable_.begin());
+  evictable_.erase(evictable_.begin());
+  in_replacer_[*frame_id] = false;
+  // The history is kept until the buffer pool calls Remove: the victim may still be pinned again by a concurrent hit.
+  return true;
+}
+
+// A pin is an access of the frame.
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (in_replacer_[frame_id]) {
+    evictable_.erase(GetEvictionKey(frame_id));
+    in_replacer_[frame_id] = false;
+  }
+  RecordAccess(frame_id);
+}
+
+// The access history only changes on Pin, so the position of an evictable frame is fixed until it is pinned again.
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (in_replacer_[frame_id]) {
+    return;
+  }
+  if (history_size_[frame_id] == 0) {
+    // The frame was loaded without going through Pin, the load itself is its first access.
+    RecordAccess(frame_id);
+  }
+  evictable_.insert(GetEvictionKey(frame_id));
+  in_replacer_[frame_id] = true;
+}
+
+void LRUKReplacer::PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) {
+  std::lock_guard<std::mutex> lock(latch_);
+  for (auto iter = evictable_.begin(); iter != evictable_.end() && frame_ids->size() < max_frames; ++iter) {
+    frame_ids->push_back(std::get<2>(*iter));
+  }
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (in_replacer_[frame_id]) {
+    evictable_.erase(GetEvictionKey(frame_id));
+    in_replacer_[frame_id] = false;
+  }
+  history_size_[frame_id] = 0;
+}
+
+size_t LRUKReplacer::Size() {
+  std::lock_guard<std::mutex> lock(latch_);
+  return evictable_.size();
+}
+
+void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
+  uint64_t now = ++current_timestamp_;
+  uint64_t *history = &history_[frame_id * k_];
+  size_t &history_size = history_size_[frame_id];
+  uint64_t previous_access = last_access_[frame_id];
+  last_access_[frame_id] = now;
+  // 窗口从上一次访问算起, 一次扫描连续读一个页的所有tuple, 不管有多少个, 都只算一次访问
+  if (history_size > 0 && now - previous_access < correlated_window_) {
+    return;
+  }
+  // A new uncorrelated access: shift the history by one and forget the oldest entry.
+  for (size_t i = std::min(history_size, k_ - 1); i > 0; i--) {
+    history[i] = history[i - 1];
+  }
+  history[0] = now;
+  if (history_size < k_) {
+    history_size++;
+  }
+}
+
+LRUKReplacer::EvictionKey LRUKReplacer::GetEvictionKey(frame_id_t frame_id) const {
+  if (history_size_[frame_id] < k_) {
+    // Infinite backward K-distance, fall back to plain LRU among these frames.
+    return {false, last_access_[frame_id], frame_id};
+  }
+  return {true, history_[frame_id * k_ + k_ - 1], frame_id};
+}
+
+}  // namespace bustub
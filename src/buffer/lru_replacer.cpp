@@ -60,6 +60,14 @@ void LRUReplacer::Unpin(frame_id_t frame_id) {
   }
 }
 
+void LRUReplacer::PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) {
+  std::lock_guard<std::mutex> lock(latch_);
+  // back端是下一个牺牲者
+  for (auto iter = list_.rbegin(); iter != list_.rend() && frame_ids->size() < max_frames; ++iter) {
+    frame_ids->push_back(*iter);
+  }
+}
+
 size_t LRUReplacer::Size() {
   std::lock_guard<std::mutex> lock(latch_);
   return list_.size();
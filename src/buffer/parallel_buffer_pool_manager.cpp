@@ -12,8 +12,11 @@
 
 #include "buffer/parallel_buffer_pool_manager.h"
 #include <sys/types.h>
+#include <algorithm>
+#include <chrono>  // NOLINT
 #include <cstddef>
 #include <new>
+#include <utility>
 #include <vector>
 #include "buffer/buffer_pool_manager_instance.h"
 // #include "common/logger.h"
@@ -21,20 +24,26 @@
 namespace bustub {
 
 ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
-                                                     LogManager *log_manager)
-    : num_instances_(num_instances), pool_size_(pool_size), start_index_(0) {
+                                                     LogManager *log_manager, ReplacerPolicy replacer_policy,
+                                                     HugePagePolicy huge_page_policy)
+    : num_instances_(num_instances), pool_size_(pool_size), start_index_(0), disk_manager_(disk_manager) {
   // Allocate and create individual BufferPoolManagerInstances
   for (size_t i = 0; i < num_instances; i++) {
     // BufferPoolManagerInstance buffer_pool(pool_size,num_instances,i, disk_manager,log_manager);
     BufferPoolManagerInstance *bmp =
-        new BufferPoolManagerInstance(pool_size, num_instances, i, disk_manager, log_manager);
+        new BufferPoolManagerInstance(pool_size, num_instances, i, disk_manager, log_manager, replacer_policy,
+                                      huge_page_policy);
+    bmp->frame_signal_ = &frame_signal_;
     buffer_pool_managers_.push_back(bmp);
   }
   // LOG_DEBUG("num_instandes = %zu, pool_size = %zu \n",num_instances, pool_size);
+  prefetcher_ = new Prefetcher(this);
 }
 
 // Update constructor to destruct all BufferPoolManagerInstances and deallocate any associated memory
 ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  // The prefetcher goes first, it may still be reading pages into the instances
+  delete prefetcher_;
   for (size_t i = 0; i < num_instances_; i++) {
     delete buffer_pool_managers_[i];
   }
@@ -45,6 +54,82 @@ size_t ParallelBufferPoolManager::GetPoolSize() {
   return num_instances_ * pool_size_;
 }
 
+void ParallelBufferPoolManager::StartBackgroundWriter(const BackgroundWriterOptions &options) {
+  // 每个实例有自己的后台写线程, 只清理自己的页
+  for (size_t i = 0; i < num_instances_; i++) {
+    BackgroundWriterOptions instance_options = options;
+    if (!options.resident_pages_file_.empty()) {
+      instance_options.resident_pages_file_ = InstanceFileName(options.resident_pages_file_, i);
+    }
+    buffer_pool_managers_[i]->StartBackgroundWriter(instance_options);
+  }
+}
+
+void ParallelBufferPoolManager::StopBackgroundWriter() {
+  for (auto *bpm : buffer_pool_managers_) {
+    bpm->StopBackgroundWriter();
+  }
+}
+
+void ParallelBufferPoolManager::EnableCompressedCache(size_t capacity_bytes) {
+  for (auto *bpm : buffer_pool_managers_) {
+    bpm->EnableCompressedCache(capacity_bytes / num_instances_);
+  }
+}
+
+CompressedPageCacheStats ParallelBufferPoolManager::GetCompressedCacheStats() {
+  CompressedPageCacheStats stats;
+  for (auto *bpm : buffer_pool_managers_) {
+    stats += bpm->GetCompressedCacheStats();
+  }
+  return stats;
+}
+
+BufferPoolStats ParallelBufferPoolManager::GetStats() {
+  BufferPoolStats stats;
+  for (auto *bpm : buffer_pool_managers_) {
+    stats += bpm->GetStats();
+  }
+  return stats;
+}
+
+BufferPoolStats ParallelBufferPoolManager::GetInstanceStats(size_t instance_index) {
+  return buffer_pool_managers_[instance_index]->GetStats();
+}
+
+void ParallelBufferPoolManager::DumpStats(std::ostream &os, size_t num_hot_pages) {
+  os << "total: " << GetStats() << "\n";
+  for (auto *bpm : buffer_pool_managers_) {
+    bpm->DumpStats(os, num_hot_pages);
+  }
+}
+
+bool ParallelBufferPoolManager::DumpResidentPages(const std::string &file_name) {
+  bool ok = true;
+  for (size_t i = 0; i < num_instances_; i++) {
+    ok = buffer_pool_managers_[i]->DumpResidentPages(InstanceFileName(file_name, i)) && ok;
+  }
+  return ok;
+}
+
+size_t ParallelBufferPoolManager::WarmUp(const std::string &file_name, bool in_background) {
+  size_t num_pages = 0;
+  for (size_t i = 0; i < num_instances_; i++) {
+    num_pages += buffer_pool_managers_[i]->WarmUp(InstanceFileName(file_name, i), in_background);
+  }
+  return num_pages;
+}
+
+void ParallelBufferPoolManager::WaitForWarmUp() {
+  for (auto *bpm : buffer_pool_managers_) {
+    bpm->WaitForWarmUp();
+  }
+}
+
+std::string ParallelBufferPoolManager::InstanceFileName(const std::string &file_name, size_t instance_index) {
+  return file_name + "." + std::to_string(instance_index);
+}
+
 BufferPoolManager *ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) {
   // Get BufferPoolManager responsible for handling given page id. You can use this method in your other methods.
   int index_of_instance = static_cast<int>(page_id % num_instances_);
@@ -57,6 +142,23 @@ Page *ParallelBufferPoolManager::FetchPgImp(page_id_t page_id) {
   return bpm->FetchPage(page_id);
 }
 
+Page *ParallelBufferPoolManager::FetchPgInRingImp(page_id_t page_id, BufferRing *ring) {
+  // Every instance recycles its own part of the ring
+  BufferPoolManager *bpm = GetBufferPoolManager(page_id);
+  return bpm->FetchPageInRing(page_id, ring);
+}
+
+void ParallelBufferPoolManager::PrefetchPgImp(page_id_t page_id, size_t num_pages, next_page_id_fn next_page_id,
+                                              std::shared_ptr<BufferRing> ring) {
+  prefetcher_->Enqueue(page_id, num_pages, next_page_id, std::move(ring));
+}
+
+bool ParallelBufferPoolManager::ReadAheadPgImp(page_id_t page_id, BufferRing *ring, next_page_id_fn next_page_id,
+                                               page_id_t *next) {
+  BufferPoolManager *bpm = GetBufferPoolManager(page_id);
+  return bpm->ReadAheadPage(page_id, ring, next_page_id, next);
+}
+
 bool ParallelBufferPoolManager::UnpinPgImp(page_id_t page_id, bool is_dirty) {
   BufferPoolManager *bpm = GetBufferPoolManager(page_id);
   return bpm->UnpinPage(page_id, is_dirty);
@@ -69,26 +171,50 @@ bool ParallelBufferPoolManager::FlushPgImp(page_id_t page_id) {
 }
 
 Page *ParallelBufferPoolManager::NewPgImp(page_id_t *page_id) {
-  // create new page. We will request page allocation in a round robin manner from the underlying
-  // BufferPoolManagerInstances
-  // 1.   From a starting index of the BPMIs, call NewPageImpl until either 1) success and return 2) looped around to
-  // starting index and return nullptr
-  // 2.   Bump the starting index (mod number of instances) to start search at a different BPMI each time this function
-  // is called
-  Page *new_page = nullptr;
-  size_t index = start_index_;
-  do {
-    new_page = buffer_pool_managers_[index]->NewPage(page_id);
+  // create new page in the least loaded BufferPoolManagerInstance, so that a full instance does not make every NewPage
+  // probe it first. The loads are (clean unpinned frames, unpinned frames), read without latching.
+  size_t start_index = start_index_.fetch_add(1, std::memory_order_relaxed) % num_instances_;
+  std::vector<std::pair<std::pair<size_t, size_t>, size_t>> candidates;
+  candidates.reserve(num_instances_);
+  for (size_t i = 0; i < num_instances_; i++) {
+    size_t index = (start_index + i) % num_instances_;
+    BufferPoolManagerInstance *bpm = buffer_pool_managers_[index];
+    candidates.push_back({{bpm->GetNumCleanUnpinnedFrames(), bpm->GetNumUnpinnedFrames()}, index});
+  }
+  // Least loaded first, round-robin order from start_index among equals. Full instances are still tried last, in
+  // case a page was unpinned meanwhile.
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const auto &a, const auto &b) { return a.first > b.first; });
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(FRAME_WAIT_TIMEOUT_MS);
+  auto try_candidates = [&]() -> Page * {
+    for (auto &candidate : candidates) {
+      Page *new_page = buffer_pool_managers_[candidate.second]->NewPgImp(page_id, false);
+      if (new_page != nullptr) {
+        return new_page;
+      }
+    }
+    return nullptr;
+  };
+  while (true) {
+    Page *new_page = try_candidates();
     if (new_page != nullptr) {
-      break;
+      return new_page;
     }
-    index = (index + 1) % num_instances_;
-  } while (index != start_index_);
-  start_index_ = (start_index_ + 1) % num_instances_;
-  // LOG_DEBUG("ParallelBufferPoolManager::NewPgImp  getPage? : %d (1 : get, 0 : not get) ",new_page != nullptr);
-  // LOG_DEBUG("ParallelBufferPoolManager::NewPgImp, get pageId = %d", *page_id);
-
-  return new_page;
+    // Every frame is pinned. A query within its quota waits for a frame of any instance rather than failing, looking
+    // once more after it is counted as a waiter so that a frame released meanwhile is not missed.
+    if (PinQuota::Current() == nullptr || PinQuota::Current()->IsUsedUp()) {
+      return nullptr;
+    }
+    uint64_t epoch = frame_signal_.AddWaiter();
+    new_page = try_candidates();
+    if (new_page != nullptr) {
+      frame_signal_.RemoveWaiter();
+      return new_page;
+    }
+    if (!frame_signal_.WaitForRelease(epoch, deadline)) {
+      return nullptr;
+    }
+  }
 }
 
 bool ParallelBufferPoolManager::DeletePgImp(page_id_t page_id) {
@@ -98,10 +224,13 @@ bool ParallelBufferPoolManager::DeletePgImp(page_id_t page_id) {
 }
 
 void ParallelBufferPoolManager::FlushAllPgsImp() {
-  // flush all pages from all BufferPoolManagerInstances
-  for (BufferPoolManager *bmp : buffer_pool_managers_) {
-    bmp->FlushAllPages();
+  // flush all pages from all BufferPoolManagerInstances. Consecutive page ids live in different instances, so the
+  // dirty pages of every instance are written together to be coalesced.
+  std::vector<BufferPoolManagerInstance::DirtyPage> dirty_pages;
+  for (BufferPoolManagerInstance *bmp : buffer_pool_managers_) {
+    bmp->CollectDirtyPages(&dirty_pages);
   }
+  BufferPoolManagerInstance::FlushDirtyPages(disk_manager_, &dirty_pages);
 }
 
 }  // namespace bustub
@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pin_quota.cpp
+//
+// Identification: src/buffer/pin_quota.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/pin_quota.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace bustub {
+
+thread_local PinQuota *PinQuota::current_ = nullptr;
+
+size_t PinQuota::DefaultMaxPins(BufferPoolManager *bpm) {
+  if (bpm == nullptr) {
+    return UNLIMITED;
+  }
+  size_t pool_size = bpm->GetPoolSize();
+  // 池子很小时百分比不够一次索引分裂用, 给一个下限, 但不超过整个池子
+  size_t min_pins = std::min<size_t>(pool_size, MIN_QUERY_PIN_QUOTA);
+  return std::max<size_t>({pool_size * QUERY_PIN_QUOTA_PERCENT / 100, min_pins, 1});
+}
+
+bool PinQuota::Charge() {
+  size_t num_pins = num_pins_.fetch_add(1, std::memory_order_relaxed) + 1;
+  size_t peak_pins = peak_pins_.load(std::memory_order_relaxed);
+  while (peak_pins < num_pins && !peak_pins_.compare_exchange_weak(peak_pins, num_pins, std::memory_order_relaxed)) {
+  }
+  return num_pins <= max_pins_;
+}
+
+void PinQuota::Release() {
+  size_t num_pins = num_pins_.load(std::memory_order_relaxed);
+  while (num_pins > 0 && !num_pins_.compare_exchange_weak(num_pins, num_pins - 1, std::memory_order_relaxed)) {
+  }
+}
+
+void PinQuota::Track(page_id_t page_id) {
+  std::lock_guard<std::mutex> lock(charged_pages_latch_);
+  charged_pages_[page_id]++;
+}
+
+bool PinQuota::ReleasePage(page_id_t page_id) {
+  {
+    std::lock_guard<std::mutex> lock(charged_pages_latch_);
+    auto iter = charged_pages_.find(page_id);
+    // 查询开始前就pin住的页没有记在配额上, unpin它不能还给配额
+    if (iter == charged_pages_.end()) {
+      return false;
+    }
+    if (--iter->second == 0) {
+      charged_pages_.erase(iter);
+    }
+  }
+  Release();
+  return true;
+}
+
+size_t AdmissionController::Reservation(const PinQuota &quota) const {
+  return std::min(quota.GetMaxPins(), capacity_);
+}
+
+void AdmissionController::Admit(const PinQuota &quota) {
+  std::unique_lock<std::mutex> lock(latch_);
+  size_t reservation = Reservation(quota);
+  if (capacity_ != 0 && reserved_ + reservation > capacity_) {
+    // 池子已经超额预订, 排队等运行中的查询结束; 超时后照样放行, 排队的查询可能持有运行中的查询在等的锁
+    num_queued_++;
+    cv_.wait_for(lock, std::chrono::milliseconds(ADMISSION_TIMEOUT_MS),
+                 [&] { return reserved_ + reservation <= capacity_; });
+    num_queued_--;
+  }
+  reserved_ += reservation;
+  num_admitted_++;
+}
+
+void AdmissionController::Leave(const PinQuota &quota) {
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    reserved_ -= Reservation(quota);
+    num_admitted_--;
+  }
+  cv_.notify_all();
+}
+
+size_t AdmissionController::GetNumAdmitted() {
+  std::lock_guard<std::mutex> lock(latch_);
+  return num_admitted_;
+}
+
+size_t AdmissionController::GetNumQueued() {
+  std::lock_guard<std::mutex> lock(latch_);
+  return num_queued_;
+}
+
+}  // namespace bustub
@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// prefetcher.cpp
+//
+// Identification: src/buffer/prefetcher.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/prefetcher.h"
+
+#include <utility>
+
+namespace bustub {
+
+Prefetcher::Prefetcher(BufferPoolManager *bpm, size_t max_pending_requests)
+    : bpm_(bpm), max_pending_requests_(max_pending_requests) {}
+
+Prefetcher::~Prefetcher() {
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  if (prefetch_thread_ != nullptr) {
+    prefetch_thread_->join();
+    delete prefetch_thread_;
+  }
+}
+
+void Prefetcher::Enqueue(page_id_t page_id, size_t num_pages, BufferPoolManager::next_page_id_fn next_page_id,
+                         std::shared_ptr<BufferRing> ring) {
+  if (page_id == INVALID_PAGE_ID || num_pages == 0) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    if (shutdown_ || requests_.size() >= max_pending_requests_) {
+      // 只是一个提示, 队列满了就丢掉
+      return;
+    }
+    requests_.push_back({page_id, num_pages, next_page_id, std::move(ring)});
+    if (prefetch_thread_ == nullptr) {
+      prefetch_thread_ = new std::thread(&Prefetcher::RunPrefetch, this);
+    }
+  }
+  cv_.notify_one();
+}
+
+void Prefetcher::RunPrefetch() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    cv_.wait(lock, [this] { return shutdown_ || !requests_.empty(); });
+    if (shutdown_) {
+      return;
+    }
+    Request request = std::move(requests_.front());
+    requests_.pop_front();
+    lock.unlock();
+    Prefetch(request);
+    lock.lock();
+  }
+}
+
+void Prefetcher::Prefetch(const Request &request) {
+  page_id_t page_id = request.page_id_;
+  for (size_t i = 0; i < request.num_pages_ && page_id != INVALID_PAGE_ID; i++) {
+    // 预读不算对页的访问, 否则扫描真正读到这个页时, replacer会把它当成第二次访问
+    page_id_t next_page_id;
+    if (!bpm_->ReadAheadPage(page_id, request.ring_.get(), request.next_page_id_, &next_page_id)) {
+      // Every frame is pinned, reading ahead would only get in the way.
+      return;
+    }
+    page_id = next_page_id;
+  }
+}
+
+}  // namespace bustub
@@ -63,14 +63,14 @@ uint32_t HASH_TABLE_TYPE::Hash(KeyType key) {
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-uint32_t HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) {
+uint32_t HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, const HashTableDirectoryPage *dir_page) {
   // 记住： bmp->fetch方法是会pin页面的，用完页面后即得unpin它，否则bufferpool空间容易满找不到空闲空间
   auto mask = dir_page->GetGlobalDepthMask();
   return Hash(key) & mask;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-page_id_t HASH_TABLE_TYPE::KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) {
+page_id_t HASH_TABLE_TYPE::KeyToPageId(KeyType key, const HashTableDirectoryPage *dir_page) {
   uint32_t directory_index = KeyToDirectoryIndex(key, dir_page);
   return dir_page->GetBucketPageId(directory_index);
 }
@@ -94,42 +94,83 @@ HASH_TABLE_BUCKET_TYPE *HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_i
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
+  bool found;
+  for (int attempt = 0; attempt < OPTIMISTIC_READ_ATTEMPTS; attempt++) {
+    if (OptimisticGetValue(key, result, &found)) {
+      return found;
+    }
+  }
+  // 乐观读多次失败(写者频繁), 退回到加锁的读
   table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  page_id_t bucket_page_id = KeyToPageId(key, dir_page);
-  HASH_TABLE_BUCKET_TYPE *bucket_page = FetchBucketPage(bucket_page_id);
-  // dynamic_cast<Page*>(bucket_page);
-  reinterpret_cast<Page *>(bucket_page)->RLatch();
-  bool ret = bucket_page->GetValue(key, comparator_, result);  // 读取桶页内容前加页的读锁
-  reinterpret_cast<Page *>(bucket_page)->RUnlatch();
-
-  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
-  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  ReadPageGuard dir_guard = buffer_pool_manager_->FetchPageRead(directory_page_id_);
+  page_id_t bucket_page_id = KeyToPageId(key, dir_guard.As<HashTableDirectoryPage>());
+  // 目录由table latch保护, 拿到bucket的page id后目录页就可以unpin了
+  dir_guard.Drop();
+  ReadPageGuard bucket_guard = buffer_pool_manager_->FetchPageRead(bucket_page_id);
+  bool ret = bucket_guard.As<HASH_TABLE_BUCKET_TYPE>()->GetValue(key, comparator_, result);
+  bucket_guard.Drop();
   table_latch_.RUnlock();
   return ret;
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::OptimisticGetValue(const KeyType &key, std::vector<ValueType> *result, bool *found) {
+  Page *dir_page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  if (dir_page == nullptr) {
+    return false;
+  }
+  // 目录的修改(分裂, 合并)都持有目录页的写latch, 读完bucket后再验证一次目录, 就知道bucket没有在这期间被分裂或合并.
+  // The directory is validated again once the bucket is pinned: a pinned bucket that is still referenced can only have
+  // its deletion put off by a Merge. A bucket deleted before the pin fails the validation, and the buffer pool drops
+  // the stale copy the fetch read back when it is unpinned.
+  alignas(HASH_TABLE_BUCKET_TYPE) char bucket_copy[PAGE_SIZE];
+  bool is_valid = false;
+  uint64_t dir_version;
+  if (dir_page->TryOptimisticRead(&dir_version)) {
+    auto dir = reinterpret_cast<const HashTableDirectoryPage *>(dir_page->GetData());
+    // 没验证过的目录可能是不一致的, 下标要检查
+    uint32_t directory_index = KeyToDirectoryIndex(key, dir);
+    page_id_t bucket_page_id =
+        directory_index < DIRECTORY_ARRAY_SIZE ? dir->GetBucketPageId(directory_index) : INVALID_PAGE_ID;
+    if (bucket_page_id != INVALID_PAGE_ID && dir_page->ValidateOptimisticRead(dir_version)) {
+      Page *bucket_page = buffer_pool_manager_->FetchPage(bucket_page_id);
+      if (bucket_page != nullptr) {
+        uint64_t bucket_version;
+        if (dir_page->ValidateOptimisticRead(dir_version) && bucket_page->TryOptimisticRead(&bucket_version)) {
+          memcpy(bucket_copy, bucket_page->GetData(), PAGE_SIZE);
+          is_valid =
+              bucket_page->ValidateOptimisticRead(bucket_version) && dir_page->ValidateOptimisticRead(dir_version);
+        }
+        buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      }
+    }
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  if (!is_valid) {
+    return false;
+  }
+  *found = reinterpret_cast<const HASH_TABLE_BUCKET_TYPE *>(bucket_copy)->GetValue(key, comparator_, result);
+  return true;
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
   table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  page_id_t bucket_page_id = KeyToPageId(key, dir_page);
-  HASH_TABLE_BUCKET_TYPE *bucket_page = FetchBucketPage(bucket_page_id);
-  // dynamic_cast<Page *>(bucket_page); 不能用dynamic_cast, 因为Page没有虚函数
-  reinterpret_cast<Page *>(bucket_page)->WLatch();
+  ReadPageGuard dir_guard = buffer_pool_manager_->FetchPageRead(directory_page_id_);
+  page_id_t bucket_page_id = KeyToPageId(key, dir_guard.As<HashTableDirectoryPage>());
+  dir_guard.Drop();
+  WritePageGuard bucket_guard = buffer_pool_manager_->FetchPageWrite(bucket_page_id);
+  auto *bucket_page = bucket_guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
   bool insert_successed = bucket_page->Insert(key, value, comparator_);
-  reinterpret_cast<Page *>(bucket_page)->WUnlatch();
-
-  // bucket 页面被修改了
-  buffer_pool_manager_->UnpinPage(bucket_page_id, true, nullptr);
-  // directory 页面没有被修改
-  buffer_pool_manager_->UnpinPage(directory_page_id_, false, nullptr);
+  // 在释放页之前判断, 释放之后这个页可能已经被换出了
+  bool is_full = bucket_page->IsFull();
+  bucket_guard.Drop();
   table_latch_.RUnlock();
   // 一定要在 split insert之前释放 hash table的读锁，因为split insert 要写锁，不然就死锁了 ！
-  if (!insert_successed && bucket_page->IsFull()) {
+  if (!insert_successed && is_full) {
     insert_successed = SplitInsert(transaction, key, value);
   }
 
@@ -139,7 +180,9 @@ bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) {
   table_latch_.WLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  // 目录页的写latch让乐观读者知道目录在变
+  WritePageGuard dir_guard = buffer_pool_manager_->FetchPageWrite(directory_page_id_);
+  HashTableDirectoryPage *dir_page = dir_guard.AsMut<HashTableDirectoryPage>();
   auto bucket_idx = KeyToDirectoryIndex(key, dir_page);
   auto bucket_page_id = KeyToPageId(key, dir_page);
   HASH_TABLE_BUCKET_TYPE *bucket_page = FetchBucketPage(bucket_page_id);
@@ -148,7 +191,7 @@ bool HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
     // 如果bucket_page没有满，则不用再分裂了， 相当于递归的中终止条件
     bool ret = bucket_page->Insert(key, value, comparator_);
     buffer_pool_manager_->UnpinPage(bucket_page_id, true);
-    buffer_pool_manager_->UnpinPage(directory_page_id_, false); // 注意这里false
+    dir_guard.Drop();
     table_latch_.WUnlock();
     return ret;
   }
@@ -158,10 +201,8 @@ bool HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
   //  如果local-depth < global_depth, 那么仅分裂bucket即可
   auto local_depth = dir_page->GetLocalDepth(bucket_idx);
   auto global_depth = dir_page->GetGlobalDepth();
-  bool derctory_spted = false;
   if (local_depth == global_depth) {
     // Directory Expansion
-    derctory_spted = true;
     ExpensionDirectory(dir_page);
 
   }
@@ -225,7 +266,7 @@ bool HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
   buffer_pool_manager_->UnpinPage(split_bucket_page_id, to_new);
 
   // 不要忘记unpin页面,这里有3个！
-  buffer_pool_manager_->UnpinPage(directory_page_id_, derctory_spted);
+  dir_guard.Drop();
 
   table_latch_.WUnlock();
 
@@ -256,22 +297,17 @@ void HASH_TABLE_TYPE::ExpensionDirectory(HashTableDirectoryPage *dir_page) {
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
   table_latch_.RLock();
-
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  page_id_t bucker_page_id = KeyToPageId(key, dir_page);
-  HASH_TABLE_BUCKET_TYPE *bucket_page = FetchBucketPage(bucker_page_id);
-
-  reinterpret_cast<Page *>(bucket_page)->WLatch();
-  // LOG_DEBUG("remove hash to page_id = %d", bucker_page_id);
+  ReadPageGuard dir_guard = buffer_pool_manager_->FetchPageRead(directory_page_id_);
+  page_id_t bucket_page_id = KeyToPageId(key, dir_guard.As<HashTableDirectoryPage>());
+  dir_guard.Drop();
+  WritePageGuard bucket_guard = buffer_pool_manager_->FetchPageWrite(bucket_page_id);
+  auto *bucket_page = bucket_guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
   bool has_deleted = bucket_page->Remove(key, value, comparator_);
-  reinterpret_cast<Page *>(bucket_page)->WUnlatch();
-
-  // 不要忘记unpin页面！！
-  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
-  buffer_pool_manager_->UnpinPage(bucker_page_id, true);
+  bool is_empty = bucket_page->IsEmpty();
+  bucket_guard.Drop();
   table_latch_.RUnlock();
   // 在释放读锁后再调用merge，因为merge要获取写锁。 否则会引发死锁
-  if (has_deleted && bucket_page->IsEmpty()) {
+  if (has_deleted && is_empty) {
     Merge(transaction, key, value);
     ExtraMerge(transaction, key, value);
   }
@@ -284,7 +320,9 @@ bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {
   table_latch_.WLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  DeleteUnreferencedBuckets();
+  WritePageGuard dir_guard = buffer_pool_manager_->FetchPageWrite(directory_page_id_);
+  HashTableDirectoryPage *dir_page = dir_guard.AsMut<HashTableDirectoryPage>();
   page_id_t bucket_empty_page_id = KeyToPageId(key, dir_page);
   uint32_t bucket_empty_index = KeyToDirectoryIndex(key, dir_page);
 
@@ -306,7 +344,7 @@ void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const
 
     // 删除空余的bucket页
     buffer_pool_manager_->UnpinPage(bucket_empty_page_id, false);
-    buffer_pool_manager_->DeletePage(bucket_empty_page_id);
+    DeleteBucketPage(bucket_empty_page_id);
     merged = true;
     // reinterpret_cast<Page *>(empty_bucket)->WUnlatch();
 
@@ -334,7 +372,7 @@ void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const
     buffer_pool_manager_->UnpinPage(bucket_empty_page_id, false);
   }
 
-  buffer_pool_manager_->UnpinPage(directory_page_id_, merged);
+  dir_guard.Drop();
   table_latch_.WUnlock();
 }
 
@@ -355,11 +393,12 @@ bool HASH_TABLE_TYPE::ShrinkDirectory(HashTableDirectoryPage *dir_page) {
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::ExtraMerge(Transaction *transaction, const KeyType &key, const ValueType &value) {
   table_latch_.WLock();
+  DeleteUnreferencedBuckets();
   // 扫描整个目录看看是否有空的bucket， 如果有则合并
-  bool has_merged = false;      // 标记每次否合并操作
-  bool has_merged_all = false;  // 标记整个循环是否有合并操作
+  bool has_merged = false;  // 标记每次否合并操作
   // extra merge 的 key 再次hash到的bucket一定不是空， 但是经过shrink后要检查这个桶的镜像桶是否为空，如果是则合并
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  WritePageGuard dir_guard = buffer_pool_manager_->FetchPageWrite(directory_page_id_);
+  HashTableDirectoryPage *dir_page = dir_guard.AsMut<HashTableDirectoryPage>();
 
   for (uint32_t index = 0; index < dir_page->Size(); index++) {
     page_id_t bucket_to_be_detected_page_id = dir_page->GetBucketPageId(index);
@@ -374,12 +413,11 @@ bool HASH_TABLE_TYPE::ExtraMerge(Transaction *transaction, const KeyType &key, c
       if (ld_of_original_bucket > 0 && (ld_of_original_bucket == ld_of_image_bucket) &&
           (bucket_to_be_detected_page_id != bucket_image_page_id)) {
         has_merged = true;
-        has_merged_all = true;
         // 删除空余的bucket页
         // reinterpret_cast<Page *>(bucket_to_be_detected)->WLatch();
         // LOG_DEBUG("delete pageid = %d", bucket_to_be_detected_page_id);
         buffer_pool_manager_->UnpinPage(bucket_to_be_detected_page_id, false);
-        buffer_pool_manager_->DeletePage(bucket_to_be_detected_page_id);
+        DeleteBucketPage(bucket_to_be_detected_page_id);
         // reinterpret_cast<Page *>(bucket_to_be_detected)->WUnlatch();
 
         for (uint32_t index = 0; index < dir_page->Size(); index++) {
@@ -395,22 +433,32 @@ bool HASH_TABLE_TYPE::ExtraMerge(Transaction *transaction, const KeyType &key, c
       }
     }
     if (has_merged) {
+      // 合并掉的bucket删除前已经unpin过了, 再unpin会把乐观读者的pin也减掉
       has_merged = false;
-      // 别忘了unpin， 这里卡了很久
-      buffer_pool_manager_->UnpinPage(bucket_to_be_detected_page_id, true);
     } else {
       buffer_pool_manager_->UnpinPage(bucket_to_be_detected_page_id, false);
     }
   }
-  if (has_merged_all) {
-    buffer_pool_manager_->UnpinPage(directory_page_id_, true);
-  } else {
-    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
-  }
-  // buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+  dir_guard.Drop();
   table_latch_.WUnlock();
   return has_merged;
 }
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::DeleteBucketPage(page_id_t bucket_page_id) {
+  // OptimisticGetValue不加table latch, 可能正pin着这个页, 这时删除会失败
+  if (!buffer_pool_manager_->DeletePage(bucket_page_id)) {
+    unreferenced_buckets_.push_back(bucket_page_id);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::DeleteUnreferencedBuckets() {
+  // 目录已经不指向这些页, 读者验证失败后很快就会unpin
+  auto still_pinned = std::remove_if(unreferenced_buckets_.begin(), unreferenced_buckets_.end(),
+                                     [this](page_id_t page_id) { return buffer_pool_manager_->DeletePage(page_id); });
+  unreferenced_buckets_.erase(still_pinned, unreferenced_buckets_.end());
+}
 // 用来debug,但是不能在加写锁的方法中使用
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_TYPE::PrintDir() {
@@ -35,7 +35,8 @@ SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNod
 void SeqScanExecutor::Init() {
   // 获取对应TableHeap的迭代器 和 TableInfo
   table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid());
-  tableheap_iterator_ = table_info_->table_->Begin(exec_ctx_->GetTransaction());
+  // 全表扫描走buffer ring, 不把其他事务的热点页挤出bufferpool; 同时在后台预读后面的页
+  tableheap_iterator_ = table_info_->table_->Begin(exec_ctx_->GetTransaction(), true, READ_AHEAD_PAGES);
 }
 
 // 注意 ： NEXT输出的元组并不等于表元组，它是没有RID的； 其RID只能从对应的表元组中得到
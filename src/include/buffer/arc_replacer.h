@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * ARCReplacer implements the Adaptive Replacement Cache policy.
+ *
+ * Resident frames are split into T1, the pages that were accessed once since they were loaded, and T2, the pages that
+ * were accessed again. The page ids of pages evicted from T1 and T2 are kept in the ghost lists B1 and B2. Loading a
+ * page found in B1 means T1 was too small, so the target size of T1 grows; loading a page found in B2 shrinks it. The
+ * victim is taken from T1 while T1 is over its target, from T2 otherwise. So the balance between recency and frequency
+ * follows the workload: a batch load keeps T1 big, point queries grow T2.
+ *
+ * A hit within the correlated reference period of the previous access of the page does not count as being accessed
+ * again, and leaves the page in its list. A scan pins a page once per tuple, back to back; without the window, every
+ * page it reads would end up in T2 and push the pages that are really used again out.
+ *
+ * The ghost lists need page ids, which the buffer pool hands over through RecordLoad and RecordEviction.
+ */
+class ARCReplacer : public Replacer {
+ public:
+  /**
+   * Create a new ARCReplacer.
+   * @param num_pages the maximum number of pages the ARCReplacer will be required to store
+   * @param correlated_window hits of a frame less than this many accesses after its previous access are correlated
+   * and do not move it to T2
+   */
+  explicit ARCReplacer(size_t num_pages, size_t correlated_window = ARC_CORRELATED_WINDOW);
+
+  /**
+   * Destroys the ARCReplacer.
+   */
+  ~ARCReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  void RecordLoad(frame_id_t frame_id, page_id_t page_id) override;
+
+  void RecordEviction(frame_id_t frame_id, page_id_t page_id) override;
+
+  size_t Size() override;
+
+  /** @return the current target size of T1, for testing */
+  size_t GetTargetT1Size();
+
+ private:
+  /** The resident list a frame belongs to. */
+  enum class ResidentList { NONE, T1, T2 };
+
+  /** A list of evicted page ids with O(1) lookup, front is the most recent. */
+  struct GhostList {
+    std::list<page_id_t> list_;
+    std::unordered_map<page_id_t, std::list<page_id_t>::iterator> map_;
+  };
+
+  /** Move the frame to the front of the given resident list. */
+  void MoveTo(frame_id_t frame_id, ResidentList target);
+
+  /** Take the frame out of its resident list. */
+  void Detach(frame_id_t frame_id);
+
+  /**
+   * Find the least recently used evictable frame of a resident list.
+   * @param list T1 or T2
+   * @param[out] frame_id the frame found
+   * @return false if every frame of the list is pinned
+   */
+  bool FindEvictable(const std::list<frame_id_t> &list, frame_id_t *frame_id) const;
+
+  /** Forget the least recently evicted page of a ghost list. */
+  static void PopGhost(GhostList *ghost);
+
+  /** Stamp an access to the frame. @return true if it is correlated with the previous access of the frame */
+  bool RecordAccess(frame_id_t frame_id);
+
+  /** Capacity of the cache, i.e. the number of frames. */
+  const size_t capacity_;
+  const size_t correlated_window_;
+  /** Logical clock, advanced on every access, and the timestamp of the last access of each frame. */
+  uint64_t current_timestamp_{0};
+  std::vector<uint64_t> last_access_;
+  /** Target size of T1. */
+  size_t target_t1_size_{0};
+  /** Resident lists of frames, front is the most recently used. Pinned frames stay in their list. */
+  std::list<frame_id_t> t1_;
+  std::list<frame_id_t> t2_;
+  GhostList b1_;
+  GhostList b2_;
+  /** The list every frame is in and its position there. */
+  std::vector<ResidentList> resident_list_;
+  std::vector<std::list<frame_id_t>::iterator> position_;
+  /** evictable_[i] is true iff frame i is unpinned and may be victimized. */
+  std::vector<bool> evictable_;
+  /** Number of evictable frames. */
+  size_t size_{0};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -13,13 +13,17 @@
 #pragma once
 
 #include <list>
+#include <memory>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <utility>
 
+#include "buffer/buffer_ring.h"
 #include "buffer/lru_replacer.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
+#include "storage/page/page_guard.h"
 
 namespace bustub {
 
@@ -30,6 +34,8 @@ class BufferPoolManager {
  public:
   enum class CallbackType { BEFORE, AFTER };
   using bufferpool_callback_fn = void (*)(enum CallbackType, const page_id_t page_id);
+  /** Reads the id of the page that follows a page in a chain of pages, e.g. the next page of a table heap. */
+  using next_page_id_fn = page_id_t (*)(Page *page);
 
   BufferPoolManager() = default;
   /**
@@ -84,6 +90,69 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
+  /**
+   * Fetch a page for a sequential scan. On a miss, the page is read into a frame recycled from the ring rather than
+   * into a victim taken from the whole pool.
+   * @param page_id id of page to be fetched
+   * @param ring the bulk-read ring of the scan
+   * @return the requested page
+   */
+  Page *FetchPageInRing(page_id_t page_id, BufferRing *ring) { return FetchPgInRingImp(page_id, ring); }
+
+  /**
+   * Fetch a page and read-latch it. The latch and the pin are given back when the guard goes out of scope.
+   * @param page_id id of page to be fetched
+   * @param ring if not nullptr, a miss recycles a frame of this bulk-read ring, as in FetchPageInRing
+   * @return a guard on the requested page, empty if the page could not be fetched
+   */
+  ReadPageGuard FetchPageRead(page_id_t page_id, BufferRing *ring = nullptr) {
+    Page *page = ring == nullptr ? FetchPgImp(page_id) : FetchPgInRingImp(page_id, ring);
+    if (page != nullptr) {
+      page->RLatch();
+    }
+    return ReadPageGuard(this, page);
+  }
+
+  /**
+   * Fetch a page and write-latch it. The latch and the pin are given back when the guard goes out of scope, and the
+   * page is unpinned dirty iff it was accessed for writing through the guard.
+   * @param page_id id of page to be fetched
+   * @return a guard on the requested page, empty if the page could not be fetched
+   */
+  WritePageGuard FetchPageWrite(page_id_t page_id) {
+    Page *page = FetchPgImp(page_id);
+    if (page != nullptr) {
+      page->WLatch();
+    }
+    return WritePageGuard(this, page);
+  }
+
+  /**
+   * Ask for pages to be read into the buffer pool in the background. This is only a hint: the pages are not pinned,
+   * and the request is dropped if too many are pending.
+   * @param page_id id of the first page to read
+   * @param num_pages how many pages of the chain starting at page_id to read
+   * @param next_page_id how to find the next page of the chain, may be nullptr if num_pages is 1
+   * @param ring if not nullptr, the pages are read into the frames of this bulk-read ring
+   */
+  void PrefetchPage(page_id_t page_id, size_t num_pages = 1, next_page_id_fn next_page_id = nullptr,
+                    std::shared_ptr<BufferRing> ring = nullptr) {
+    PrefetchPgImp(page_id, num_pages, next_page_id, std::move(ring));
+  }
+
+  /**
+   * Read a page ahead of its use, as the prefetcher does. This is no access to the page: a resident page is neither
+   * pinned nor shown to the replacer, and a page read in is left unpinned.
+   * @param page_id id of page to be read
+   * @param ring if not nullptr, a miss recycles a frame of this bulk-read ring, as in FetchPageInRing
+   * @param next_page_id how to find the next page of the chain, may be nullptr
+   * @param[out] next the next page of the chain, INVALID_PAGE_ID if next_page_id is nullptr
+   * @return false if the page could not be read because every frame is pinned
+   */
+  bool ReadAheadPage(page_id_t page_id, BufferRing *ring, next_page_id_fn next_page_id, page_id_t *next) {
+    return ReadAheadPgImp(page_id, ring, next_page_id, next);
+  }
+
   /** @return size of the buffer pool */
   virtual size_t GetPoolSize() = 0;
 
@@ -108,6 +177,46 @@ class BufferPoolManager {
    */
   virtual Page *FetchPgImp(page_id_t page_id) = 0;
 
+  /**
+   * Fetch the requested page from the buffer pool, recycling the frames of a ring on a miss. Buffer pools without
+   * rings fetch it like any other page.
+   * @param page_id id of page to be fetched
+   * @param ring the bulk-read ring of the caller
+   * @return the requested page
+   */
+  virtual Page *FetchPgInRingImp(page_id_t page_id, __attribute__((unused)) BufferRing *ring) {
+    return FetchPgImp(page_id);
+  }
+
+  /**
+   * Read pages into the buffer pool in the background. Buffer pools without a background reader ignore the hint.
+   * @param page_id id of the first page to read
+   * @param num_pages how many pages of the chain starting at page_id to read
+   * @param next_page_id how to find the next page of the chain
+   * @param ring the bulk-read ring the pages are read into, or nullptr
+   */
+  virtual void PrefetchPgImp(__attribute__((unused)) page_id_t page_id, __attribute__((unused)) size_t num_pages,
+                             __attribute__((unused)) next_page_id_fn next_page_id,
+                             __attribute__((unused)) std::shared_ptr<BufferRing> ring) {}
+
+  /**
+   * Read a page ahead of its use. Buffer pools that cannot tell a read-ahead from an access fetch and unpin the page.
+   * @param page_id id of page to be read
+   * @param ring the bulk-read ring to read it into, or nullptr
+   * @param next_page_id how to find the next page of the chain, may be nullptr
+   * @param[out] next the next page of the chain
+   * @return false if the page could not be read
+   */
+  virtual bool ReadAheadPgImp(page_id_t page_id, BufferRing *ring, next_page_id_fn next_page_id, page_id_t *next) {
+    Page *page = ring != nullptr ? FetchPgInRingImp(page_id, ring) : FetchPgImp(page_id);
+    if (page == nullptr) {
+      return false;
+    }
+    *next = next_page_id != nullptr ? next_page_id(page) : INVALID_PAGE_ID;
+    UnpinPgImp(page_id, false);
+    return true;
+  }
+
   /**
    * Unpin the target page from the buffer pool.
    * @param page_id id of page to be unpinned
@@ -12,31 +12,106 @@
 
 #pragma once
 
+#include <array>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
 #include <list>
-#include <mutex>  // NOLINT
+#include <memory>
+#include <mutex>   // NOLINT
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "buffer/arc_replacer.h"
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_stats.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/compressed_page_cache.h"
+#include "buffer/frame_arena.h"
+#include "buffer/lru_k_replacer.h"
 #include "buffer/lru_replacer.h"
+#include "buffer/pin_quota.h"
+#include "buffer/prefetcher.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
 
 namespace bustub {
 
+/**
+ * Tuning knobs of the background writer. Every round, the writer looks at the next high_watermark_ victims of the
+ * replacer. Once fewer than low_watermark_ of them are clean, it writes the dirty ones back, at most
+ * max_pages_per_round_ pages per round, over as many rounds as it takes for high_watermark_ of them to be clean.
+ */
+struct BackgroundWriterOptions {
+  /** How long the writer sleeps between two rounds. */
+  std::chrono::milliseconds interval_{BG_WRITER_INTERVAL_MS};
+  /** Rate limit: the most pages written in one round. */
+  size_t max_pages_per_round_{BG_WRITER_MAX_PAGES};
+  size_t low_watermark_{BG_WRITER_LOW_WATERMARK};
+  size_t high_watermark_{BG_WRITER_HIGH_WATERMARK};
+  /** If not empty, the writer also dumps the resident pages there for a later warm-up, see DumpResidentPages. */
+  std::string resident_pages_file_;
+  /** How many rounds pass between two dumps of the resident pages. */
+  size_t dump_interval_rounds_{BG_WRITER_DUMP_ROUNDS};
+};
+
+/**
+ * Lets queries wait for a frame to be unpinned or freed. The instances of a parallel BPM share one, so that a query
+ * waits for a frame of any of them.
+ */
+class FrameReleaseSignal {
+ public:
+  /**
+   * Count the calling thread as a waiter, before it looks for a frame one last time. A frame released after this is
+   * either found by that look or wakes the thread up, since the release happens under a latch the look also takes.
+   * @return the epoch to wait on, see WaitForRelease
+   */
+  uint64_t AddWaiter();
+
+  /** The waiter found a frame after all and does not wait. */
+  void RemoveWaiter();
+
+  /** A frame was unpinned or freed, wake up the waiters. Costs a single load if there are none. */
+  void Notify();
+
+  /**
+   * Wait for a release after the given epoch, then stop counting the calling thread as a waiter.
+   * @return false if the deadline passed first
+   */
+  bool WaitForRelease(uint64_t epoch, std::chrono::steady_clock::time_point deadline);
+
+ private:
+  /** Count of the releases seen by waiters, protected by latch_. */
+  uint64_t epoch_{0};
+  /** Threads between AddWaiter and the end of their wait, Notify does nothing if there are none. */
+  std::atomic<size_t> num_waiters_{0};
+  std::mutex latch_;
+  std::condition_variable cv_;
+};
+
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
  *注意 ： 在BPM 和 LRU 中的pin 和 unpin 有着相反的意思
  */
 class BufferPoolManagerInstance : public BufferPoolManager {
+  friend class ParallelBufferPoolManager;
+
  public:
   /**
    * Creates a new BufferPoolManagerInstance.
    * @param pool_size the size of the buffer pool
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_policy the replacement policy used to pick victim frames
+   * @param huge_page_policy how the memory of the frames is backed
    */
-  BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr);
+  BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                            ReplacerPolicy replacer_policy = ReplacerPolicy::LRU,
+                            HugePagePolicy huge_page_policy = HugePagePolicy::NONE);
   /**
    * Creates a new BufferPoolManagerInstance.
    * @param pool_size the size of the buffer pool
@@ -44,9 +119,13 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param instance_index index of this BPI in the parallel BPM
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_policy the replacement policy used to pick victim frames
+   * @param huge_page_policy how the memory of the frames is backed
    */
   BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
-                            DiskManager *disk_manager, LogManager *log_manager = nullptr);
+                            DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                            ReplacerPolicy replacer_policy = ReplacerPolicy::LRU,
+                            HugePagePolicy huge_page_policy = HugePagePolicy::NONE);
 
   /**
    * Destroys an existing BufferPoolManagerInstance.
@@ -59,6 +138,79 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** @return pointer to all the pages in the buffer pool */
   Page *GetPages() { return pages_; }
 
+  /** @return how the memory of the frames is actually backed */
+  HugePagePolicy GetHugePagePolicy() const { return frame_arena_->GetHugePagePolicy(); }
+
+  /**
+   * Start a thread that writes dirty unpinned pages back before the replacer picks them as victims, so that the
+   * foreground threads mostly evict clean pages. Does nothing if the writer is already running.
+   * @param options the rate and the watermarks of the writer
+   */
+  void StartBackgroundWriter(const BackgroundWriterOptions &options = BackgroundWriterOptions());
+
+  /**
+   * Stop the background writer and wait for it to finish its round. Does nothing if it is not running.
+   */
+  void StopBackgroundWriter();
+
+  /**
+   * @return how many frames are free or hold an unpinned page, i.e. how many pages NewPage could still place. Read
+   * without latching, so it may be slightly off while pages are being pinned and unpinned.
+   */
+  size_t GetNumUnpinnedFrames();
+
+  /** @return how many of the unpinned frames are free or clean, i.e. can be reused without a write-back */
+  size_t GetNumCleanUnpinnedFrames();
+
+  /**
+   * Keep the pages evicted from this instance in a compressed in-memory cache, which a miss checks before reading
+   * the disk. Must be called before the instance is used.
+   * @param capacity_bytes how many compressed bytes the cache may hold
+   */
+  void EnableCompressedCache(size_t capacity_bytes);
+
+  /** @return a snapshot of the counters of the compressed cache, all zero if it is not enabled */
+  CompressedPageCacheStats GetCompressedCacheStats();
+
+  /** @return a snapshot of the statistics of this instance since it was created */
+  BufferPoolStats GetStats();
+
+  /**
+   * @param page_id id of a page
+   * @return how many times the page was pinned since it was last brought into the pool, 0 if it is not resident
+   */
+  uint64_t GetPageAccessCount(page_id_t page_id);
+
+  /**
+   * Write the statistics of this instance, followed by its most accessed resident pages.
+   * @param os where to write them
+   * @param num_hot_pages how many of the most accessed pages to list
+   */
+  void DumpStats(std::ostream &os, size_t num_hot_pages = 10);
+
+  /**
+   * Write the ids of the resident pages to a file, coldest first in the order of the replacer, pinned pages last.
+   * The file is replaced atomically, so a crash during the dump leaves the previous one in place.
+   * @param file_name the file to write
+   * @return false if the file could not be written
+   */
+  bool DumpResidentPages(const std::string &file_name);
+
+  /**
+   * Read back the pages dumped by DumpResidentPages, e.g. after a restart, so that the pool does not start cold.
+   * Only the hottest pages that fit are read, coldest first so that the replacer ends up in the dumped order. Within
+   * batches of WARM_UP_BATCH_SIZE pages they are read in page id order, which keeps the disk reads mostly sequential.
+   * The warm-up only fills free frames: it stops once no frame is free, so it never evicts a page of the traffic.
+   * @param file_name the file written by DumpResidentPages
+   * @param in_background false to read the pages before returning, true to read them on a background thread while
+   * the pool serves traffic
+   * @return how many pages were read, or are to be read in the background
+   */
+  size_t WarmUp(const std::string &file_name, bool in_background = false);
+
+  /** Wait for a background warm-up to finish. Does nothing if none is running. */
+  void WaitForWarmUp();
+
  protected:
   /**
    * Fetch the requested page from the buffer pool.
@@ -67,6 +219,46 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   Page *FetchPgImp(page_id_t page_id) override;
 
+  /**
+   * Fetch the requested page from the buffer pool. On a miss, the next frame of this instance's share of the ring is
+   * recycled if it still holds the page the ring read into it; otherwise a frame is found the usual way and joins
+   * the ring.
+   * @param page_id id of page to be fetched
+   * @param ring the bulk-read ring of the caller, nullptr for a regular fetch
+   * @return the requested page
+   */
+  Page *FetchPgInRingImp(page_id_t page_id, BufferRing *ring) override;
+
+  /**
+   * Fetch a page like FetchPgInRingImp, but for a read-ahead: if the page turns out to be resident, it is not pinned.
+   * @param page_id id of page to be fetched
+   * @param ring the bulk-read ring of the caller, nullptr for a regular fetch
+   * @param[out] is_resident set if the page was resident, in which case nullptr is returned
+   * @return the page read in, pinned once
+   */
+  Page *FetchPgInRingImp(page_id_t page_id, BufferRing *ring, bool *is_resident);
+
+  /**
+   * Read a page ahead of its use. A resident page is left alone, its link to the next page is read under the shard
+   * latch; only a miss reads the page in, which the replacer sees as a load and not as an access.
+   * @param page_id id of page to be read
+   * @param ring the bulk-read ring to read it into, or nullptr
+   * @param next_page_id how to find the next page of the chain, may be nullptr
+   * @param[out] next the next page of the chain
+   * @return false if the page could not be read because every frame is pinned
+   */
+  bool ReadAheadPgImp(page_id_t page_id, BufferRing *ring, next_page_id_fn next_page_id, page_id_t *next) override;
+
+  /**
+   * Queue pages to be read in the background by the prefetcher.
+   * @param page_id id of the first page to read
+   * @param num_pages how many pages of the chain starting at page_id to read
+   * @param next_page_id how to find the next page of the chain
+   * @param ring the bulk-read ring the pages are read into, or nullptr
+   */
+  void PrefetchPgImp(page_id_t page_id, size_t num_pages, next_page_id_fn next_page_id,
+                     std::shared_ptr<BufferRing> ring) override;
+
   /**
    * Unpin the target page from the buffer pool.
    * @param page_id id of page to be unpinned
@@ -89,6 +281,14 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   Page *NewPgImp(page_id_t *page_id) override;
 
+  /**
+   * Creates a new page in the buffer pool.
+   * @param[out] page_id id of created page
+   * @param wait_for_frame if true and the caller runs a query, wait for a frame to be unpinned when all are pinned
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  Page *NewPgImp(page_id_t *page_id, bool wait_for_frame);
+
   /**
    * Deletes a page from the buffer pool.
    * @param page_id id of page to be deleted
@@ -102,18 +302,16 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   void FlushAllPgsImp() override;
 
   /**
-   * Allocate a page on disk.∂
+   * Allocate a page on disk. The lowest page id deallocated by this instance is reused first.
    * @return the id of the allocated page
    */
   page_id_t AllocatePage();
 
   /**
-   * Deallocate a page on disk.
+   * Deallocate a page on disk, so that its id is handed out again by AllocatePage.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
-  }
+  void DeallocatePage(page_id_t page_id);
 
   /**
    * Validate that the page_id being used is accessible to this BPI. This can be used in all of the functions to
@@ -122,8 +320,202 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   void ValidatePageId(page_id_t page_id) const;
 
-  //在 freeList或者lru中找到一个空闲的frame_page_id
+  /** Number of shards the page table is split into. Page ids are spread over the shards round-robin. */
+  static constexpr size_t NUM_PAGE_TABLE_SHARDS = 64;
+
+  /**
+   * A shard of the page table. Its latch protects the mapping as well as the book-keeping fields (pin count, dirty
+   * flag, I/O state, access count) of every frame that currently holds one of its pages. Shards are cache-line
+   * aligned so that threads hitting different shards do not bounce the same line.
+   */
+  struct alignas(64) PageTableShard {
+    std::mutex latch_;
+    /** Signalled whenever the I/O on a frame of this shard completes. */
+    std::condition_variable io_cv_;
+    std::unordered_map<page_id_t, frame_id_t> page_table_;
+    /** Statistics of the pages of this shard, kept next to its latch so that bumping them is nearly free. */
+    BufferPoolCounters stats_;
+    /**
+     * What the pages of this shard added to the number of unpinned frames, and of clean unpinned frames, of the
+     * instance. Only the sum over all the shards is meaningful: a frame may be pinned under one shard and freed
+     * under another, so a single delta can go negative. Kept per shard so that pinning never bounces a shared line.
+     */
+    std::atomic<int64_t> unpinned_frames_delta_{0};
+    std::atomic<int64_t> clean_unpinned_frames_delta_{0};
+  };
+
+  /** @return the page table shard responsible for the given page id */
+  PageTableShard &GetShard(page_id_t page_id) {
+    return page_table_shards_[static_cast<uint32_t>(page_id) / num_instances_ % NUM_PAGE_TABLE_SHARDS];
+  }
+
+  /**
+   * Find a free frame in the free list or evict one through the replacer. A dirty victim is written back without
+   * holding any latch, so other fetches keep going while the write is in flight. No latch may be held by the caller.
+   * @param[out] frame_page_id the frame that now belongs to the caller
+   * @return false if every frame is pinned
+   */
   bool FindFramePageId(frame_id_t *frame_page_id);
+
+  /**
+   * Find a frame like FindFramePageId. If every frame is pinned and the caller may wait, wait up to
+   * FRAME_WAIT_TIMEOUT_MS for one to be unpinned. No latch may be held by the caller.
+   * @param[out] frame_page_id the frame that now belongs to the caller
+   * @param wait_for_frame whether to wait while every frame is pinned
+   * @return false if every frame is (still) pinned
+   */
+  bool AcquireFrame(frame_id_t *frame_page_id, bool wait_for_frame);
+
+  /**
+   * Evict the given page from the given frame, writing it back if it is dirty. Fails if the frame no longer holds the
+   * page or the page is pinned. No latch may be held by the caller.
+   * @param frame_id the frame to take over
+   * @param page_id the page the caller expects in the frame
+   * @return true if the frame is now free and belongs to the caller
+   */
+  bool EvictFrame(frame_id_t frame_id, page_id_t page_id);
+
+  /**
+   * Map a page that is not resident to a frame that belongs to the caller, pin it, and read its content. The shard
+   * latch is released during the read; other fetches of the page wait for it.
+   * @param shard the shard of the page, its latch is held through lock
+   * @param lock the lock on the shard latch, held again on return
+   * @param page_id the page to read
+   * @param frame_id the frame to read it into
+   * @return the page, pinned once
+   */
+  Page *LoadPage(PageTableShard *shard, std::unique_lock<std::mutex> *lock, page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * Drop the copy of a deallocated page that a stale fetch read back into the pool, so that its id can be handed out
+   * again without orphaning that frame. The frame goes back to the free list.
+   * @param shard the shard of the page, its latch is held through lock
+   * @param lock the lock on the shard latch, held again on return
+   * @param page_id the deallocated page
+   * @return false if the stale copy is still pinned, true if the page is not resident (any more)
+   */
+  bool DropStalePage(PageTableShard *shard, std::unique_lock<std::mutex> *lock, page_id_t page_id);
+
+  /**
+   * Unmap an unpinned frame without writing it back and return it to the free list.
+   * @param shard the shard of the page in the frame, its latch must be held
+   * @param frame_id the frame to free
+   */
+  void DiscardFrame(PageTableShard *shard, frame_id_t frame_id);
+
+  /**
+   * Take the next slot of this instance's share of the ring, which is set up on first use. The slot may only be
+   * updated under the latch of the ring.
+   * @param ring the bulk-read ring of the caller
+   * @param[out] content what the slot holds now
+   * @return the slot
+   */
+  BufferRing::Slot *NextRingSlot(BufferRing *ring, BufferRing::Slot *content);
+
+  /** A dirty page to be written back by a batched flush, and the instance it lives in. */
+  using DirtyPage = std::pair<page_id_t, BufferPoolManagerInstance *>;
+
+  /**
+   * Take a snapshot of the dirty pages of this instance.
+   * @param[out] dirty_pages the dirty pages are appended here
+   */
+  void CollectDirtyPages(std::vector<DirtyPage> *dirty_pages);
+
+  /**
+   * Hand a dirty page over to a batched flush: its dirty flag is cleared and its frame is put under I/O until EndFlush.
+   * @param page_id the page to write back
+   * @param[out] frame_id the frame of the page
+   * @return false if the page is no longer resident or no longer dirty
+   */
+  bool BeginFlush(page_id_t page_id, frame_id_t *frame_id);
+
+  /**
+   * Take a page back from a batched flush once it has been written.
+   * @param page_id the page that was written back
+   * @param frame_id the frame of the page
+   */
+  void EndFlush(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * Write dirty pages back in page id order. Runs of consecutive page ids become single writes, and the file is
+   * synced once at the end. At most FLUSH_BATCH_SIZE pages are kept under I/O at a time.
+   * @param disk_manager the disk manager shared by the instances of the pages
+   * @param dirty_pages the pages to write back, from CollectDirtyPages; sorted in place
+   */
+  static void FlushDirtyPages(DiskManager *disk_manager, std::vector<DirtyPage> *dirty_pages);
+
+  /**
+   * Collect the resident pages of this instance, coldest first as for DumpResidentPages.
+   * @param[out] page_ids the page ids are appended here
+   */
+  void CollectResidentPages(std::vector<page_id_t> *page_ids);
+
+  /**
+   * Write page ids to a file, one per line, through a temporary file that is synced and then renamed over it, so that
+   * a crash leaves either the old list or the new one.
+   * @return false if the file could not be written
+   */
+  static bool WritePageIds(const std::string &file_name, const std::vector<page_id_t> &page_ids);
+
+  /**
+   * Read the page ids written by WritePageIds.
+   * @return false if the file could not be read
+   */
+  static bool ReadPageIds(const std::string &file_name, std::vector<page_id_t> *page_ids);
+
+  /**
+   * Pick the pages of a warm-up: the hottest pages of this instance that are still allocated and fit in the pool,
+   * coldest first, sorted within each batch.
+   * @param[in,out] page_ids the dumped pages, coldest first
+   */
+  void PlanWarmUp(std::vector<page_id_t> *page_ids);
+
+  /**
+   * Read the pages of a warm-up into free frames, and leave them unpinned.
+   * @param page_ids the pages from PlanWarmUp
+   * @return how many pages were read
+   */
+  size_t RunWarmUp(const std::vector<page_id_t> &page_ids);
+
+  /** Body of the background writer thread. */
+  void RunBackgroundWriter();
+
+  /**
+   * One round of the background writer.
+   * @return the number of pages written back
+   */
+  size_t CleanVictims();
+
+  /**
+   * Hand a page that is about to be evicted over to a write-back: its dirty flag is cleared and its frame is put under
+   * I/O until EndCleanFrame. Skipped if the frame no longer holds the page, or if it is pinned, clean or already under
+   * I/O. No latch may be held by the caller.
+   * @param frame_id the frame of the page
+   * @param page_id the page the caller expects in the frame
+   * @return true if the caller is to write the page back
+   */
+  bool BeginCleanFrame(frame_id_t frame_id, page_id_t page_id);
+
+  /** The write-back of a page handed over by BeginCleanFrame is done. */
+  void EndCleanFrame(frame_id_t frame_id, page_id_t page_id);
+
+  /**
+   * Update the pin count and the dirty flag of a frame, and the unpinned frame counts along with them. Every change of
+   * either field goes through here. The shard latch must be held.
+   * @param shard the shard of the page held by the frame
+   * @param page the frame
+   * @param pin_count the new pin count
+   * @param is_dirty the new dirty flag
+   */
+  void SetFrameState(PageTableShard *shard, Page *page, int pin_count, bool is_dirty);
+
+  /**
+   * Clear the I/O-in-flight state of a frame and wake up the waiters of its shard. The shard latch must be held.
+   * @param shard the shard of the page held by the frame
+   * @param frame_id the frame whose I/O has finished
+   */
+  void FinishIo(PageTableShard *shard, frame_id_t frame_id);
+
   /** Number of pages in the buffer pool. */
   const size_t pool_size_;
   /** How many instances are in the parallel BPM（Buffer Pool Manafer） (if present, otherwise just 1 BPI)
@@ -133,20 +525,51 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   const uint32_t instance_index_ = 0;
   /** Each BPI maintains its own counter for page_ids to hand out, must ensure they mod back to its instance_index_ */
   std::atomic<page_id_t> next_page_id_ = instance_index_;
+  /** Deallocated page ids of this instance, to be handed out again lowest first. */
+  std::set<page_id_t> free_page_ids_;
+  /** This latch protects free_page_ids_ only. */
+  std::mutex free_page_ids_latch_;
 
-  /** Array of buffer pool pages. */
+  /** The data of the frames, in one contiguous region. */
+  FrameArena *frame_arena_;
+  /** Array of buffer pool pages, i.e. the book-keeping of the frames. Page i holds the data of frame i. */
   Page *pages_;
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
+  /**
+   * Page table for keeping track of buffer pool pages, split into independently latched shards. Shard latches are
+   * never held across a DiskManager call: frames under I/O are marked is_io_in_progress_ instead.
+   */
+  std::array<PageTableShard, NUM_PAGE_TABLE_SHARDS> page_table_shards_;
   /** Replacer to find unpinned pages for replacement. */
   Replacer *replacer_;
   /** List of free pages. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
-  std::mutex latch_;
+  /** This latch protects free_list_ only. It is taken on the miss path, never on a hit. */
+  std::mutex free_list_latch_;
+  /** Reads pages ahead for the scans. */
+  Prefetcher *prefetcher_;
+  /** The second tier of the evicted pages, nullptr unless enabled. */
+  CompressedPageCache *compressed_cache_{nullptr};
+  /** The background writer, nullptr while it is not running. */
+  std::thread *bg_writer_thread_{nullptr};
+  BackgroundWriterOptions bg_writer_options_;
+  /** True from the round that fell below the low watermark until the high watermark is reached. Writer thread only. */
+  bool bg_writer_cleaning_{false};
+  bool bg_writer_stop_{false};
+  /** Protects the background writer state and lets StopBackgroundWriter wake the writer up. */
+  std::mutex bg_writer_latch_;
+  std::condition_variable bg_writer_cv_;
+  /** The background warm-up, nullptr if none was started since the last WaitForWarmUp. */
+  std::thread *warm_up_thread_{nullptr};
+  /** Tells a background warm-up to give up, set when the instance is destroyed. */
+  std::atomic<bool> warm_up_stop_{false};
+  /** Protects warm_up_thread_. */
+  std::mutex warm_up_latch_;
+  /** Signalled whenever a frame is unpinned or freed. A parallel BPM points it to the one its instances share. */
+  FrameReleaseSignal own_frame_signal_;
+  FrameReleaseSignal *frame_signal_{&own_frame_signal_};
 };
 }  // namespace bustub
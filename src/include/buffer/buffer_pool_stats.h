@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.h
+//
+// Identification: src/include/buffer/buffer_pool_stats.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+namespace bustub {
+
+/**
+ * A snapshot of the statistics of a buffer pool. The counters are read one by one while the pool keeps running, so
+ * a snapshot is not a consistent cut: e.g. hits_ + misses_ may be a few fetches ahead of what evictions_ accounts for.
+ */
+struct BufferPoolStats {
+  /** Fetches that found the page in the pool. */
+  uint64_t hits_{0};
+  /** Fetches that had to read the page from disk. */
+  uint64_t misses_{0};
+  /** Pages evicted to make room for another page. */
+  uint64_t evictions_{0};
+  /** Pages written back to disk, by eviction, flush or the background writer. */
+  uint64_t write_backs_{0};
+  /** Fetches that had to wait for a read or a write-back of the page to finish before pinning it. */
+  uint64_t pin_waits_{0};
+  /** Time spent in DiskManager reads and writes, in nanoseconds. */
+  uint64_t disk_read_ns_{0};
+  uint64_t disk_write_ns_{0};
+
+  /** @return the share of the fetches that were hits, 0 if there were none */
+  double HitRatio() const {
+    uint64_t fetches = hits_ + misses_;
+    return fetches == 0 ? 0 : static_cast<double>(hits_) / static_cast<double>(fetches);
+  }
+
+  BufferPoolStats &operator+=(const BufferPoolStats &that) {
+    hits_ += that.hits_;
+    misses_ += that.misses_;
+    evictions_ += that.evictions_;
+    write_backs_ += that.write_backs_;
+    pin_waits_ += that.pin_waits_;
+    disk_read_ns_ += that.disk_read_ns_;
+    disk_write_ns_ += that.disk_write_ns_;
+    return *this;
+  }
+
+  /** @return the statistics on one line, for logging */
+  std::string ToString() const;
+
+  friend std::ostream &operator<<(std::ostream &os, const BufferPoolStats &stats) {
+    os << stats.ToString();
+    return os;
+  }
+};
+
+/**
+ * The live counters behind BufferPoolStats. They are bumped with relaxed atomics, which cost about as much as plain
+ * increments on x86, and every page table shard has its own set so that they stay on cache lines the shard latch
+ * already brought in. Leave them on under full load.
+ */
+struct BufferPoolCounters {
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> evictions_{0};
+  std::atomic<uint64_t> write_backs_{0};
+  std::atomic<uint64_t> pin_waits_{0};
+  std::atomic<uint64_t> disk_read_ns_{0};
+  std::atomic<uint64_t> disk_write_ns_{0};
+
+  /** Add to a counter, one by default. */
+  static void Bump(std::atomic<uint64_t> *counter, uint64_t delta = 1) {
+    counter->fetch_add(delta, std::memory_order_relaxed);
+  }
+
+  /** Add the counters to a snapshot. */
+  void AddTo(BufferPoolStats *stats) const {
+    stats->hits_ += hits_.load(std::memory_order_relaxed);
+    stats->misses_ += misses_.load(std::memory_order_relaxed);
+    stats->evictions_ += evictions_.load(std::memory_order_relaxed);
+    stats->write_backs_ += write_backs_.load(std::memory_order_relaxed);
+    stats->pin_waits_ += pin_waits_.load(std::memory_order_relaxed);
+    stats->disk_read_ns_ += disk_read_ns_.load(std::memory_order_relaxed);
+    stats->disk_write_ns_ += disk_write_ns_.load(std::memory_order_relaxed);
+  }
+};
+
+/**
+ * Adds the time from its construction to its destruction to a counter, in nanoseconds. Used around DiskManager calls.
+ */
+class DiskTimer {
+ public:
+  explicit DiskTimer(std::atomic<uint64_t> *counter) : counter_(counter), start_(std::chrono::steady_clock::now()) {}
+
+  ~DiskTimer() {
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+    BufferPoolCounters::Bump(counter_, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+  }
+
+  DiskTimer(const DiskTimer &) = delete;
+  DiskTimer &operator=(const DiskTimer &) = delete;
+
+ private:
+  std::atomic<uint64_t> *counter_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_ring.h
+//
+// Identification: src/include/buffer/buffer_ring.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+class BufferPoolManagerInstance;
+
+/**
+ * BufferRing is the bulk-read access strategy of a sequential scan.
+ *
+ * Pages fetched through a ring that miss the buffer pool are read into a small set of frames that the ring recycles
+ * in turn, instead of into a victim chosen among all the frames of the pool. A full-table scan therefore occupies at
+ * most the size of the ring and leaves the working set of everybody else alone. A frame is only recycled if it still
+ * holds the page the ring put there and nobody has it pinned; otherwise the ring gives it up and takes a frame the
+ * usual way.
+ *
+ * A ring belongs to one scan, but the read-ahead of the scan fills it from a background thread.
+ */
+class BufferRing {
+ public:
+  /**
+   * Create a new BufferRing.
+   * @param size the number of frames recycled by the ring, split among the instances of a parallel buffer pool
+   */
+  explicit BufferRing(size_t size = BUFFER_RING_SIZE) : size_(size) {}
+
+  /** @return the number of frames recycled by the ring */
+  size_t GetSize() const { return size_; }
+
+ private:
+  friend class BufferPoolManagerInstance;
+
+  /** A frame of the ring, and the page the ring read into it. */
+  struct Slot {
+    frame_id_t frame_id_{0};
+    page_id_t page_id_{INVALID_PAGE_ID};
+  };
+
+  /** The part of the ring that lives in one buffer pool instance. */
+  struct InstanceRing {
+    std::vector<Slot> slots_;
+    /** The slot to recycle next. */
+    size_t next_{0};
+  };
+
+  const size_t size_;
+  std::unordered_map<const BufferPoolManagerInstance *, InstanceRing> instance_rings_;
+  /** Protects instance_rings_. It is never held while taking another latch. */
+  std::mutex latch_;
+};
+
+}  // namespace bustub
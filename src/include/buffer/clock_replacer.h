@@ -12,7 +12,6 @@
 
 #pragma once
 
-#include <list>
 #include <mutex>  // NOLINT
 #include <vector>
 
@@ -23,6 +22,10 @@ namespace bustub {
 
 /**
  * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ *
+ * Every frame owns a slot in two flat arrays: whether it is in the replacer, and its reference bit. Pin and Unpin only
+ * flip flags under the latch, so they never allocate. Victim sweeps the clock hand under the same latch and gives
+ * every frame a second chance by clearing its reference bit before evicting it.
  */
 class ClockReplacer : public Replacer {
  public:
@@ -43,10 +46,23 @@ class ClockReplacer : public Replacer {
 
   void Unpin(frame_id_t frame_id) override;
 
+  void PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) override;
+
   size_t Size() override;
 
  private:
-  // TODO(student): implement me!
+  /** Number of frames, i.e. the size of the flat arrays. */
+  const size_t num_pages_;
+  /** in_replacer_[i] is true iff frame i is unpinned and may be victimized. */
+  std::vector<bool> in_replacer_;
+  /** ref_bits_[i] is set when frame i is unpinned and cleared when the clock hand passes over it. */
+  std::vector<bool> ref_bits_;
+  /** Number of frames that are currently in the replacer. */
+  size_t size_{0};
+  /** The frame the clock hand points at. */
+  size_t clock_hand_{0};
+  /** Protects everything above, so that size_ always matches in_replacer_. */
+  std::mutex latch_;
 };
 
 }  // namespace bustub
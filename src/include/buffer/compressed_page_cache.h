@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.h
+//
+// Identification: src/include/buffer/compressed_page_cache.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/** A snapshot of the counters of a CompressedPageCache. */
+struct CompressedPageCacheStats {
+  /** Buffer pool misses that looked the page up, and how many of them found it. */
+  uint64_t lookups_{0};
+  uint64_t hits_{0};
+  /** Pages stored, and pages turned away because they did not compress. */
+  uint64_t inserts_{0};
+  uint64_t rejects_{0};
+  /** Pages dropped to make room for others. */
+  uint64_t evictions_{0};
+  /** Bytes of the stored pages before and after compression. */
+  uint64_t uncompressed_bytes_{0};
+  uint64_t compressed_bytes_{0};
+
+  CompressedPageCacheStats &operator+=(const CompressedPageCacheStats &that) {
+    lookups_ += that.lookups_;
+    hits_ += that.hits_;
+    inserts_ += that.inserts_;
+    rejects_ += that.rejects_;
+    evictions_ += that.evictions_;
+    uncompressed_bytes_ += that.uncompressed_bytes_;
+    compressed_bytes_ += that.compressed_bytes_;
+    return *this;
+  }
+
+  /** @return the share of the lookups that were hits, 0 if there were none */
+  double HitRatio() const { return lookups_ == 0 ? 0 : static_cast<double>(hits_) / static_cast<double>(lookups_); }
+
+  /** @return how many times smaller the stored pages got, 0 if none was stored */
+  double CompressionRatio() const {
+    return compressed_bytes_ == 0 ? 0 : static_cast<double>(uncompressed_bytes_) / static_cast<double>(compressed_bytes_);
+  }
+};
+
+/**
+ * CompressedPageCache is a second tier between the buffer pool and the disk. Pages evicted from the buffer pool are
+ * kept compressed in memory, up to a budget of compressed bytes, and a later miss on one of them decompresses it
+ * instead of reading it from disk.
+ *
+ * The cache is exclusive: a page found by Lookup leaves the cache, since it is back in the buffer pool, and comes back
+ * when it is evicted again. So the cached copy never has to be invalidated on a write; the buffer pool only erases
+ * pages it deletes. Pages are only cached once they are clean, i.e. the disk has the same content, and are dropped
+ * least recently inserted first.
+ *
+ * The codec is a byte-oriented run-length scheme, fast enough to run on every eviction: table and index pages keep
+ * their free space zeroed in the middle of the page, which it squeezes out.
+ */
+class CompressedPageCache {
+ public:
+  /**
+   * Creates a new CompressedPageCache.
+   * @param capacity_bytes how many compressed bytes the cache may hold
+   */
+  explicit CompressedPageCache(size_t capacity_bytes);
+
+  /**
+   * Compress a page.
+   * @param data the PAGE_SIZE bytes of the page
+   * @param[out] compressed the compressed page
+   * @return false if the page does not get smaller, in which case it is not worth caching
+   */
+  static bool Compress(const char *data, std::vector<char> *compressed);
+
+  /**
+   * Decompress a page compressed by Compress.
+   * @param compressed the compressed page
+   * @param[out] data the PAGE_SIZE bytes of the page
+   * @return false if the compressed page is corrupt
+   */
+  static bool Decompress(const std::vector<char> &compressed, char *data);
+
+  /**
+   * Store a clean page that leaves the buffer pool, replacing the copy of the page the cache may hold.
+   * @param page_id id of the page
+   * @param data the PAGE_SIZE bytes of the page
+   */
+  void Insert(page_id_t page_id, const char *data);
+
+  /**
+   * Take a page out of the cache.
+   * @param page_id id of the page
+   * @param[out] data the PAGE_SIZE bytes of the page, if it was cached
+   * @return true if the page was cached
+   */
+  bool Lookup(page_id_t page_id, char *data);
+
+  /**
+   * Drop the copy of a page, e.g. because it was deleted.
+   * @param page_id id of the page
+   */
+  void Erase(page_id_t page_id);
+
+  /** @return how many compressed bytes the cache holds */
+  size_t GetSize();
+
+  /** @return a snapshot of the counters */
+  CompressedPageCacheStats GetStats();
+
+ private:
+  struct Entry {
+    std::vector<char> compressed_;
+    /** Position in lru_list_. */
+    std::list<page_id_t>::iterator lru_iter_;
+  };
+
+  /** Drop an entry. The latch must be held. */
+  void EraseEntry(std::unordered_map<page_id_t, Entry>::iterator iter);
+
+  const size_t capacity_bytes_;
+  size_t size_bytes_{0};
+  std::unordered_map<page_id_t, Entry> entries_;
+  /** Page ids from the most to the least recently inserted. */
+  std::list<page_id_t> lru_list_;
+  CompressedPageCacheStats stats_;
+  /** Protects everything above. Pages are compressed before it is taken. */
+  std::mutex latch_;
+};
+
+}  // namespace bustub
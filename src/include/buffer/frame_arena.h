@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.h
+//
+// Identification: src/include/buffer/frame_arena.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/** How the memory of the buffer pool frames is backed. */
+enum class HugePagePolicy {
+  /** Regular pages of the operating system. */
+  NONE,
+  /** Transparent huge pages: the region is aligned to a huge page and the kernel is advised to back it with them. */
+  TRANSPARENT,
+  /** Pages from the reserved huge page pool (MAP_HUGETLB), falling back to TRANSPARENT if none are available. */
+  EXPLICIT,
+};
+
+/**
+ * FrameArena is the memory behind the frames of a buffer pool: one contiguous region with the data of frame i at
+ * offset i * PAGE_SIZE. Every frame is PAGE_SIZE aligned, as direct I/O requires, and the region can be backed by
+ * huge pages so that a large pool takes far fewer TLB entries. The region is zero filled when it is mapped.
+ */
+class FrameArena {
+ public:
+  /** Size of a huge page on x86-64. */
+  static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+  /**
+   * Map the region. Throws if the memory cannot be mapped.
+   * @param num_frames how many frames the region holds
+   * @param policy how the region should be backed
+   */
+  FrameArena(size_t num_frames, HugePagePolicy policy);
+
+  /** Unmap the region. */
+  ~FrameArena();
+
+  DISALLOW_COPY_AND_MOVE(FrameArena);
+
+  /** @return the data of a frame */
+  char *GetFrameData(frame_id_t frame_id) { return data_ + static_cast<size_t>(frame_id) * PAGE_SIZE; }
+
+  /** @return how the region is actually backed, which may differ from the policy asked for after a fallback */
+  HugePagePolicy GetHugePagePolicy() const { return policy_; }
+
+ private:
+  /** Map the region backed by regular or transparent huge pages. */
+  void MapRegular(size_t size, bool transparent_huge_pages);
+
+  /** Where the mapping starts and how long it is, possibly more than the frames need in order to align them. */
+  void *mapping_{nullptr};
+  size_t mapping_size_{0};
+  /** The data of frame 0. */
+  char *data_{nullptr};
+  HugePagePolicy policy_;
+};
+
+}  // namespace bustub
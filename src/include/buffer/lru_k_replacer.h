@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.h
+//
+// Identification: src/include/buffer/lru_k_replacer.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy.
+ *
+ * Every access (a Pin) is stamped with a logical timestamp. The victim is the evictable frame whose K-th most recent
+ * access is the oldest, i.e. whose backward K-distance is the largest. Frames with fewer than K recorded accesses have
+ * an infinite distance and are evicted first, least recently used first. So a page touched once by a sequential scan
+ * goes before a page that is looked up again and again.
+ *
+ * An access that falls within the correlated reference period of the previous access of the frame continues the same
+ * burst, and a burst counts as a single access. A scan visits every tuple of a page back to back; without the window,
+ * that burst alone would make the page look hot.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k the number of accesses looked back at
+   * @param correlated_window accesses of a frame less than this many timestamps after its previous access are
+   * correlated and do not count as a new access
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k = LRUK_REPLACER_K, size_t correlated_window = LRUK_CORRELATED_WINDOW);
+
+  /**
+   * Destroys the LRUKReplacer.
+   */
+  ~LRUKReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void PeekVictims(size_t max_frames, std::vector<frame_id_t> *frame_ids) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+ private:
+  /** Evictable frames are ordered by (has K accesses, timestamp the order is based on, frame id). */
+  using EvictionKey = std::tuple<bool, uint64_t, frame_id_t>;
+
+  /** Stamp an access to the frame, folding it into the current burst if it is correlated. */
+  void RecordAccess(frame_id_t frame_id);
+
+  /** @return the position of the frame in evictable_, computed from its access history */
+  EvictionKey GetEvictionKey(frame_id_t frame_id) const;
+
+  const size_t k_;
+  const size_t correlated_window_;
+  /** Logical clock, advanced on every access. */
+  uint64_t current_timestamp_{0};
+  /** history_[frame * k_ + i] is the start of the i-th most recent burst of accesses of the frame. */
+  std::vector<uint64_t> history_;
+  /** Number of valid entries in the history of each frame, at most k_. */
+  std::vector<size_t> history_size_;
+  /** Timestamp of the last access of each frame, correlated or not. */
+  std::vector<uint64_t> last_access_;
+  /** in_replacer_[i] is true iff frame i is evictable, i.e. in evictable_. */
+  std::vector<bool> in_replacer_;
+  /** Evictable frames, the victim is the first one. */
+  std::set<EvictionKey> evictable_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
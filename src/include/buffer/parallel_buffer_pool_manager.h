@@ -12,7 +12,10 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstddef>
+#include <iostream>
+#include <string>
 #include <vector>
 #include "buffer/buffer_pool_manager.h"
 
@@ -32,9 +35,12 @@ class ParallelBufferPoolManager : public BufferPoolManager {
    * @param pool_size the pool size of each BufferPoolManagerInstance
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_policy the replacement policy of every BufferPoolManagerInstance
+   * @param huge_page_policy how the memory of the frames of every BufferPoolManagerInstance is backed
    */
   ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
-                            LogManager *log_manager = nullptr);
+                            LogManager *log_manager = nullptr, ReplacerPolicy replacer_policy = ReplacerPolicy::LRU,
+                            HugePagePolicy huge_page_policy = HugePagePolicy::NONE);
 
   /**
    * Destroys an existing ParallelBufferPoolManager.
@@ -44,6 +50,63 @@ class ParallelBufferPoolManager : public BufferPoolManager {
   /** @return size of the buffer pool */
   size_t GetPoolSize() override;
 
+  /**
+   * Start the background writer of every BufferPoolManagerInstance. If the options name a resident pages file, every
+   * instance dumps its resident pages to its own file next to it, see DumpResidentPages.
+   * @param options the rate and the watermarks of each writer
+   */
+  void StartBackgroundWriter(const BackgroundWriterOptions &options = BackgroundWriterOptions());
+
+  /**
+   * Stop the background writer of every BufferPoolManagerInstance.
+   */
+  void StopBackgroundWriter();
+
+  /**
+   * Give every BufferPoolManagerInstance a compressed cache of its evicted pages. Must be called before the pool is
+   * used.
+   * @param capacity_bytes how many compressed bytes the caches may hold together
+   */
+  void EnableCompressedCache(size_t capacity_bytes);
+
+  /** @return a snapshot of the counters of the compressed caches, added up */
+  CompressedPageCacheStats GetCompressedCacheStats();
+
+  /** @return a snapshot of the statistics of all the BufferPoolManagerInstances, added up */
+  BufferPoolStats GetStats();
+
+  /**
+   * @param instance_index index of a BufferPoolManagerInstance
+   * @return a snapshot of the statistics of that instance
+   */
+  BufferPoolStats GetInstanceStats(size_t instance_index);
+
+  /**
+   * Write the statistics of the whole pool, followed by those of every instance and its most accessed pages.
+   * @param os where to write them
+   * @param num_hot_pages how many of the most accessed pages to list per instance
+   */
+  void DumpStats(std::ostream &os, size_t num_hot_pages = 10);
+
+  /**
+   * Write the ids of the resident pages of every BufferPoolManagerInstance, each instance to its own file.
+   * @param file_name the files are named file_name.<instance index>
+   * @return false if a file could not be written
+   */
+  bool DumpResidentPages(const std::string &file_name);
+
+  /**
+   * Warm up every BufferPoolManagerInstance from the files written by DumpResidentPages. In the background, the
+   * instances are warmed up in parallel.
+   * @param file_name the name DumpResidentPages was given
+   * @param in_background false to read the pages before returning, true to read them while serving traffic
+   * @return how many pages were read, or are to be read in the background
+   */
+  size_t WarmUp(const std::string &file_name, bool in_background = false);
+
+  /** Wait for the background warm-up of every BufferPoolManagerInstance to finish. */
+  void WaitForWarmUp();
+
  protected:
   /**
    * @param page_id id of page
@@ -51,6 +114,9 @@ class ParallelBufferPoolManager : public BufferPoolManager {
    */
   BufferPoolManager *GetBufferPoolManager(page_id_t page_id);
 
+  /** @return the file the instance at the given index dumps its resident pages to */
+  static std::string InstanceFileName(const std::string &file_name, size_t instance_index);
+
   /**
    * Fetch the requested page from the buffer pool.
    * @param page_id id of page to be fetched
@@ -58,6 +124,34 @@ class ParallelBufferPoolManager : public BufferPoolManager {
    */
   Page *FetchPgImp(page_id_t page_id) override;
 
+  /**
+   * Fetch the requested page from the buffer pool, recycling the frames of a ring on a miss.
+   * @param page_id id of page to be fetched
+   * @param ring the bulk-read ring of the caller
+   * @return the requested page
+   */
+  Page *FetchPgInRingImp(page_id_t page_id, BufferRing *ring) override;
+
+  /**
+   * Queue pages to be read in the background by the prefetcher.
+   * @param page_id id of the first page to read
+   * @param num_pages how many pages of the chain starting at page_id to read
+   * @param next_page_id how to find the next page of the chain
+   * @param ring the bulk-read ring the pages are read into, or nullptr
+   */
+  void PrefetchPgImp(page_id_t page_id, size_t num_pages, next_page_id_fn next_page_id,
+                     std::shared_ptr<BufferRing> ring) override;
+
+  /**
+   * Read a page ahead of its use in the responsible BufferPoolManagerInstance.
+   * @param page_id id of page to be read
+   * @param ring the bulk-read ring to read it into, or nullptr
+   * @param next_page_id how to find the next page of the chain, may be nullptr
+   * @param[out] next the next page of the chain
+   * @return false if the page could not be read
+   */
+  bool ReadAheadPgImp(page_id_t page_id, BufferRing *ring, next_page_id_fn next_page_id, page_id_t *next) override;
+
   /**
    * Unpin the target page from the buffer pool.
    * @param page_id id of page to be unpinned
@@ -74,7 +168,9 @@ class ParallelBufferPoolManager : public BufferPoolManager {
   bool FlushPgImp(page_id_t page_id) override;
 
   /**
-   * Creates a new page in the buffer pool.
+   * Creates a new page in the buffer pool, in the instance with the most clean unpinned frames, then the most unpinned
+   * frames. Ties go round-robin. The counts are read without any latch, so if the chosen instance turns out to be
+   * full, the others are tried from the least to the most loaded.
    * @param[out] page_id id of created page
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
@@ -99,6 +195,15 @@ class ParallelBufferPoolManager : public BufferPoolManager {
 
   size_t pool_size_;
 
-  size_t start_index_;
+  /** Shared by the instances, so that NewPage in a query waits for a frame of any of them. */
+  FrameReleaseSignal frame_signal_;
+  /** Where the search for the least loaded instance starts, bumped by every NewPage so that ties go round-robin. */
+  std::atomic<size_t> start_index_;
+
+  /** The disk manager shared by all the instances. */
+  DiskManager *disk_manager_;
+
+  /** Reads pages ahead for the scans, routing every page to its instance. */
+  Prefetcher *prefetcher_;
 };
 }  // namespace bustub
@@ -0,0 +1,158 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pin_quota.h
+//
+// Identification: src/include/buffer/pin_quota.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstddef>
+#include <limits>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+
+#include "common/config.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+
+/**
+ * Accounts for the pins a query holds. While a thread runs the query (see PinQuota::Scope), every page it pins
+ * through a BufferPoolManagerInstance is charged to the quota, and unpinning such a page gives the pin back; pins
+ * taken outside of the query are neither charged nor given back. A pin within the quota waits for a frame to be
+ * unpinned rather than failing when the pool is momentarily full. A pin past the quota does not wait: it gets a frame
+ * only if one can be freed right away, as outside of a query, so a query that keeps too many pages pinned cannot
+ * starve the others by queueing for frames.
+ */
+class PinQuota {
+ public:
+  /** A quota that never runs out. */
+  static constexpr size_t UNLIMITED = std::numeric_limits<size_t>::max();
+
+  /** @param max_pins how many pins the query may hold at once */
+  explicit PinQuota(size_t max_pins) : max_pins_(max_pins) {}
+
+  /**
+   * @return the default quota of a query running on bpm: QUERY_PIN_QUOTA_PERCENT of its pool, but at least
+   * MIN_QUERY_PIN_QUOTA (the most a single operation such as an index split pins) or the whole of a smaller pool;
+   * unlimited if there is no pool
+   */
+  static size_t DefaultMaxPins(BufferPoolManager *bpm);
+
+  /** @return how many pins the query may hold at once */
+  size_t GetMaxPins() const { return max_pins_; }
+
+  /** @return how many pins the query holds now */
+  size_t GetNumPins() const { return num_pins_.load(std::memory_order_relaxed); }
+
+  /** @return the most pins the query held at once */
+  size_t GetPeakPins() const { return peak_pins_.load(std::memory_order_relaxed); }
+
+  /** @return true if the next pin would be past the quota */
+  bool IsUsedUp() const { return GetNumPins() >= max_pins_; }
+
+  /**
+   * Charge one pin to the quota, even if it is used up.
+   * @return false if the pin is past the quota, i.e. must not wait for a frame
+   */
+  bool Charge();
+
+  /** Give back a pin charged by Charge that did not end up on a page, e.g. because no frame was free. */
+  void Release();
+
+  /** The pin just charged by Charge is on the given page. */
+  void Track(page_id_t page_id);
+
+  /**
+   * Give back a pin of the given page, if one was charged to the quota. Pins taken before the query started are not.
+   * @return true if a pin was given back
+   */
+  bool ReleasePage(page_id_t page_id);
+
+  /** @return the quota of the query the calling thread runs, nullptr outside of a query */
+  static PinQuota *Current() { return current_; }
+
+  /** Charges the pins of the calling thread to a quota for as long as it lives. Scopes nest. */
+  class Scope {
+   public:
+    explicit Scope(PinQuota *quota) : previous_(current_) { current_ = quota; }
+    ~Scope() { current_ = previous_; }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+   private:
+    PinQuota *previous_;
+  };
+
+ private:
+  static thread_local PinQuota *current_;
+
+  const size_t max_pins_;
+  std::atomic<size_t> num_pins_{0};
+  std::atomic<size_t> peak_pins_{0};
+  /** How many of the charged pins are on each page. */
+  std::unordered_map<page_id_t, size_t> charged_pages_;
+  std::mutex charged_pages_latch_;
+};
+
+/**
+ * Queues queries while the pool is oversubscribed: a query is admitted once the quotas of the running queries and
+ * its own fit in the pool. A query that has queued for ADMISSION_TIMEOUT_MS is admitted anyway, since it may hold
+ * locks a running query waits for. A single query is always admitted, however large its quota.
+ */
+class AdmissionController {
+ public:
+  /** @param capacity how many frames the quotas of the running queries may add up to, 0 for no limit */
+  explicit AdmissionController(size_t capacity) : capacity_(capacity) {}
+
+  /** Wait until the query may run. */
+  void Admit(const PinQuota &quota);
+
+  /** The query is done, let the queued ones in. */
+  void Leave(const PinQuota &quota);
+
+  /** @return how many queries run */
+  size_t GetNumAdmitted();
+
+  /** @return how many queries wait to run */
+  size_t GetNumQueued();
+
+  /** Admits a query for as long as it lives. */
+  class Ticket {
+   public:
+    Ticket(AdmissionController *controller, const PinQuota *quota) : controller_(controller), quota_(quota) {
+      controller_->Admit(*quota_);
+    }
+    ~Ticket() { controller_->Leave(*quota_); }
+
+    Ticket(const Ticket &) = delete;
+    Ticket &operator=(const Ticket &) = delete;
+
+   private:
+    AdmissionController *controller_;
+    const PinQuota *quota_;
+  };
+
+ private:
+  /** @return the frames a query reserves: its quota, but no more than the whole capacity */
+  size_t Reservation(const PinQuota &quota) const;
+
+  const size_t capacity_;
+  size_t reserved_{0};
+  size_t num_admitted_{0};
+  size_t num_queued_{0};
+  std::mutex latch_;
+  std::condition_variable cv_;
+};
+
+}  // namespace bustub
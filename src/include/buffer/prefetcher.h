@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// prefetcher.h
+//
+// Identification: src/include/buffer/prefetcher.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * Prefetcher reads pages into a buffer pool on a background thread, so that a sequential scan finds its next pages
+ * already in memory instead of waiting for the disk at every page boundary.
+ *
+ * A request names the first page of a chain and how many pages to read along it. The thread reads the pages through
+ * BufferPoolManager::ReadAheadPage, so requests routed through a parallel buffer pool may cross instances, and a
+ * read-ahead is not mistaken for an access by the replacer. The thread is started on the first request.
+ */
+class Prefetcher {
+ public:
+  /**
+   * Creates a new Prefetcher.
+   * @param bpm the buffer pool the pages are read into
+   * @param max_pending_requests requests beyond this many pending ones are dropped
+   */
+  explicit Prefetcher(BufferPoolManager *bpm, size_t max_pending_requests = PREFETCH_QUEUE_SIZE);
+
+  /**
+   * Stops the background thread. Pending requests are dropped. Must run before the buffer pool is torn down.
+   */
+  ~Prefetcher();
+
+  /**
+   * Queue a request, see BufferPoolManager::PrefetchPage.
+   */
+  void Enqueue(page_id_t page_id, size_t num_pages, BufferPoolManager::next_page_id_fn next_page_id,
+               std::shared_ptr<BufferRing> ring);
+
+ private:
+  struct Request {
+    page_id_t page_id_;
+    size_t num_pages_;
+    BufferPoolManager::next_page_id_fn next_page_id_;
+    /** Keeps the ring alive after the scan that owns it is done. */
+    std::shared_ptr<BufferRing> ring_;
+  };
+
+  /** Body of the background thread. */
+  void RunPrefetch();
+
+  /** Read the pages of one request. */
+  void Prefetch(const Request &request);
+
+  BufferPoolManager *bpm_;
+  const size_t max_pending_requests_;
+  std::deque<Request> requests_;
+  bool shutdown_{false};
+  /** Protects requests_, shutdown_ and prefetch_thread_. */
+  std::mutex latch_;
+  std::condition_variable cv_;
+  std::thread *prefetch_thread_{nullptr};
+};
+
+}  // namespace bustub
@@ -12,10 +12,15 @@
 
 #pragma once
 
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+/** The replacement policies a buffer pool can be configured with. */
+enum class ReplacerPolicy { LRU, CLOCK, LRU_K, ARC };
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -43,6 +48,38 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Forgets a frame whose page has left the buffer pool (evicted or deleted). Unlike Pin, this is not an access: a
+   * policy that keeps per-frame history must not let the next page loaded into the frame inherit it.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
+  /**
+   * Tells the replacer that a page has been read into (or created in) a frame. The frame is pinned by the caller.
+   * Policies that only look at frames can ignore it.
+   * @param frame_id the id of the frame the page was loaded into
+   * @param page_id the id of the loaded page
+   */
+  virtual void RecordLoad(__attribute__((unused)) frame_id_t frame_id, __attribute__((unused)) page_id_t page_id) {}
+
+  /**
+   * Tells the replacer that the page held by a victim frame has been evicted from the buffer pool. Policies that
+   * remember recently evicted pages get the page id here; for the others it is the same as Remove.
+   * @param frame_id the id of the victim frame
+   * @param page_id the id of the page that was evicted
+   */
+  virtual void RecordEviction(frame_id_t frame_id, __attribute__((unused)) page_id_t page_id) { Remove(frame_id); }
+
+  /**
+   * Lists the frames that Victim would return next, in that order, without removing them. Used by the background
+   * writer to clean the frames that are about to be evicted. Policies that cannot tell list nothing.
+   * @param max_frames the maximum number of frames to list
+   * @param[out] frame_ids the frames, most likely victim first
+   */
+  virtual void PeekVictims(__attribute__((unused)) size_t max_frames,
+                           __attribute__((unused)) std::vector<frame_id_t> *frame_ids) {}
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
 };
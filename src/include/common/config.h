@@ -35,6 +35,28 @@ static constexpr int PAGE_SIZE = 4096;                                        //
 static constexpr int BUFFER_POOL_SIZE = 10;                                   // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr int LRUK_REPLACER_K = 2;                                     // lookback window for lru-k replacer
+static constexpr int LRUK_CORRELATED_WINDOW = 64;                             // correlated reference period of lru-k
+static constexpr int ARC_CORRELATED_WINDOW = 64;                              // correlated reference period of arc
+static constexpr int BUFFER_RING_SIZE = 32;                                   // frames recycled by a bulk-read scan
+static constexpr int READ_AHEAD_PAGES = 4;                                    // pages a sequential scan reads ahead
+static constexpr int PREFETCH_QUEUE_SIZE = 64;                                // pending read-ahead requests per bpm
+static constexpr int BG_WRITER_INTERVAL_MS = 20;                              // sleep of the background writer
+static constexpr int BG_WRITER_MAX_PAGES = 16;                                // pages written per writer round
+static constexpr int BG_WRITER_LOW_WATERMARK = 4;                             // clean victims that trigger cleaning
+static constexpr int BG_WRITER_HIGH_WATERMARK = 16;                           // clean victims the writer aims for
+static constexpr int FLUSH_BATCH_SIZE = 64;                                   // pages held under I/O by a batched flush
+static constexpr int PREALLOCATE_PAGES = 64;                                  // pages the db file is extended by
+static constexpr int DB_SEGMENT_PAGES = (1 << 30) / PAGE_SIZE;                // pages per segment file of the db
+static constexpr int OPTIMISTIC_READ_ATTEMPTS = 4;                            // optimistic reads before latching
+static constexpr int WARM_UP_BATCH_SIZE = 64;                                 // pages sorted together by a warm-up
+static constexpr int BG_WRITER_DUMP_ROUNDS = 500;                             // writer rounds between resident dumps
+static constexpr int QUERY_PIN_QUOTA_PERCENT = 25;                            // share of the pool a query may pin
+static constexpr int MIN_QUERY_PIN_QUOTA = 8;                                 // pins a query gets on any pool
+static constexpr int FRAME_WAIT_TIMEOUT_MS = 1000;                            // how long a query waits for a frame
+static constexpr int ADMISSION_TIMEOUT_MS = 1000;                             // how long a query queues at most
+static constexpr int ASYNC_IO_QUEUE_DEPTH = 128;                              // async requests queued or in flight
+static constexpr int ASYNC_IO_THREADS = 4;                                    // threads of the async I/O fallback
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
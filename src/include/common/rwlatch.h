@@ -12,7 +12,7 @@
 
 #pragma once
 
-#include <climits>
+#include <atomic>
 #include <condition_variable>  // NOLINT
 #include <mutex>               // NOLINT
 
@@ -21,12 +21,18 @@
 namespace bustub {
 
 /**
- * Reader-Writer latch backed by std::mutex.
+ * Reader-Writer latch. The reader count and a writer bit share one atomic word, so an uncontended RLock or WLock is a
+ * single compare-and-swap. A thread that cannot get the latch spins for a while, then parks on a condition variable.
+ * Writers are preferred: once a writer is waiting, new readers wait for it.
  */
 class ReaderWriterLatch {
   using mutex_t = std::mutex;
   using cond_t = std::condition_variable;
-  static const uint32_t MAX_READERS = UINT_MAX;
+  /** Set while a writer holds the latch or waits for the readers to leave. */
+  static constexpr uint32_t WRITER = 1U << 31;
+  static constexpr uint32_t MAX_READERS = WRITER - 1;
+  /** How many times a thread checks the latch before it parks. */
+  static constexpr int SPIN_ROUNDS = 64;
 
  public:
   ReaderWriterLatch() = default;
@@ -38,59 +44,96 @@ class ReaderWriterLatch {
    * Acquire a write latch.
    */
   void WLock() {
-    std::unique_lock<mutex_t> latch(mutex_);
-    while (writer_entered_) {
-      reader_.wait(latch);
-    }
-    writer_entered_ = true;
-    while (reader_count_ > 0) {
-      writer_.wait(latch);
-    }
+    // 先抢到写者位, 之后新来的读者都会等待; 再等已经进来的读者离开
+    Acquire([this] { return TryEnterWriter(); });
+    Acquire([this] { return (state_.load() & MAX_READERS) == 0; });
   }
 
   /**
    * Release a write latch.
    */
   void WUnlock() {
-    std::lock_guard<mutex_t> guard(mutex_);
-    writer_entered_ = false;
-    reader_.notify_all();
+    state_.fetch_and(~WRITER);
+    WakeUp();
   }
 
   /**
    * Acquire a read latch.
    */
   void RLock() {
-    std::unique_lock<mutex_t> latch(mutex_);
-    while (writer_entered_ || reader_count_ == MAX_READERS) {
-      reader_.wait(latch);
-    }
-    reader_count_++;
+    Acquire([this] { return TryEnterReader(); });
   }
 
   /**
    * Release a read latch.
    */
   void RUnlock() {
-    std::lock_guard<mutex_t> guard(mutex_);
-    reader_count_--;
-    if (writer_entered_) {
-      if (reader_count_ == 0) {
-        writer_.notify_one();
+    uint32_t state = state_.fetch_sub(1);
+    uint32_t reader_count = state & MAX_READERS;
+    // 最后一个读者离开时叫醒等待的写者
+    if (((state & WRITER) != 0 && reader_count == 1) || reader_count == MAX_READERS) {
+      WakeUp();
+    }
+  }
+
+ private:
+  bool TryEnterWriter() {
+    uint32_t state = state_.load();
+    while ((state & WRITER) == 0) {
+      if (state_.compare_exchange_weak(state, state | WRITER)) {
+        return true;
       }
-    } else {
-      if (reader_count_ == MAX_READERS - 1) {
-        reader_.notify_one();
+    }
+    return false;
+  }
+
+  bool TryEnterReader() {
+    uint32_t state = state_.load();
+    while ((state & WRITER) == 0 && state != MAX_READERS) {
+      if (state_.compare_exchange_weak(state, state + 1)) {
+        return true;
       }
     }
+    return false;
   }
 
- private:
+  /**
+   * Spin until the predicate holds, then park until it does. The predicate fails only if the latch is taken, so
+   * whoever releases it will wake the parked threads up.
+   */
+  template <class Predicate>
+  void Acquire(Predicate predicate) {
+    for (int round = 0; round < SPIN_ROUNDS; round++) {
+      if (predicate()) {
+        return;
+      }
+      CpuRelax();
+    }
+    std::unique_lock<mutex_t> latch(mutex_);
+    // waiters_要在再次检查之前加一, 释放者改完state_之后再看waiters_, 两边至少有一边能看到对方
+    waiters_++;
+    cond_.wait(latch, predicate);
+    waiters_--;
+  }
+
+  void WakeUp() {
+    if (waiters_.load() > 0) {
+      std::lock_guard<mutex_t> guard(mutex_);
+      cond_.notify_all();
+    }
+  }
+
+  static void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+  }
+
+  std::atomic<uint32_t> state_{0};
+  /** Number of parked threads. */
+  std::atomic<uint32_t> waiters_{0};
   mutex_t mutex_;
-  cond_t writer_;
-  cond_t reader_;
-  uint32_t reader_count_{0};
-  bool writer_entered_{false};
+  cond_t cond_;
 };
 
 }  // namespace bustub
@@ -115,7 +115,7 @@ class ExtendibleHashTable {
    * @param dir_page to use for lookup of global depth
    * @return the directory index
    */
-  uint32_t KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page);
+  uint32_t KeyToDirectoryIndex(KeyType key, const HashTableDirectoryPage *dir_page);
 
   /**
    * Get the bucket page_id corresponding to a key.
@@ -124,7 +124,18 @@ class ExtendibleHashTable {
    * @param dir_page a pointer to the hash table's directory page
    * @return the bucket page_id corresponding to the input key
    */
-  page_id_t KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page);
+  page_id_t KeyToPageId(KeyType key, const HashTableDirectoryPage *dir_page);
+
+  /**
+   * Look a key up without taking the table latch or any page latch. The directory and the bucket are read
+   * optimistically, the bucket into a private copy, and the lookup only runs once both reads are validated.
+   *
+   * @param key the key to look up
+   * @param[out] result the values associated with the key
+   * @param[out] found whether any value was found
+   * @return false if a writer got in the way, in which case nothing was looked up
+   */
+  bool OptimisticGetValue(const KeyType &key, std::vector<ValueType> *result, bool *found);
 
   /**
    * Fetches the directory page from the buffer pool manager.
@@ -178,6 +189,17 @@ class ExtendibleHashTable {
   HASH_TABLE_BUCKET_TYPE *CreateBucketPage(page_id_t *bucket_page_id);
   void RemoveAllItem(Transaction *transaction, uint32_t bucket_idx);
 
+  /**
+   * Delete a bucket page that the directory no longer refers to. A lock-free reader may still have it pinned, then
+   * the deletion is put off until the next merge. The table latch must be held in write mode.
+   *
+   * @param bucket_page_id the page_id of the bucket, already unpinned by the caller
+   */
+  void DeleteBucketPage(page_id_t bucket_page_id);
+
+  /** Retry the deletions put off by DeleteBucketPage. The table latch must be held in write mode. */
+  void DeleteUnreferencedBuckets();
+
   // member variables
   page_id_t directory_page_id_;
   BufferPoolManager *buffer_pool_manager_;
@@ -187,6 +209,9 @@ class ExtendibleHashTable {
   ReaderWriterLatch table_latch_;
   HashFunction<KeyType> hash_fn_;
 
+  // 合并掉但还被乐观读者pin着的bucket页, 由之后的合并删除; protected by table_latch_
+  std::vector<page_id_t> unreferenced_buckets_;
+
   // for debug
   // std::unordered_map<page_id_t, page_id_t> is_deleted_;
 };
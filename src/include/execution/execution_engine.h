@@ -36,7 +36,7 @@ class ExecutionEngine {
    * @param catalog The catalog used by the execution engine
    */
   ExecutionEngine(BufferPoolManager *bpm, TransactionManager *txn_mgr, Catalog *catalog)
-      : bpm_{bpm}, txn_mgr_{txn_mgr}, catalog_{catalog} {}
+      : bpm_{bpm}, txn_mgr_{txn_mgr}, catalog_{catalog}, admission_{bpm == nullptr ? 0 : bpm->GetPoolSize()} {}
 
   DISALLOW_COPY_AND_MOVE(ExecutionEngine);
 
@@ -50,6 +50,10 @@ class ExecutionEngine {
    */
   bool Execute(const AbstractPlanNode *plan, std::vector<Tuple> *result_set, Transaction *txn,
                ExecutorContext *exec_ctx) {
+    // 池子超额预订时排队; 之后本线程的pin都记在这个查询的配额上
+    AdmissionController::Ticket ticket(&admission_, exec_ctx->GetPinQuota());
+    PinQuota::Scope pin_scope(exec_ctx->GetPinQuota());
+
     // Construct and executor for the plan
     auto executor = ExecutorFactory::CreateExecutor(exec_ctx, plan);
 
@@ -82,6 +86,8 @@ class ExecutionEngine {
   [[maybe_unused]] TransactionManager *txn_mgr_;
   /** The catalog used during query execution */
   [[maybe_unused]] Catalog *catalog_;
+  /** Queues the queries whose pin quotas do not fit in the pool */
+  AdmissionController admission_;
 };
 
 }  // namespace bustub
@@ -16,6 +16,7 @@
 #include <utility>
 #include <vector>
 
+#include "buffer/pin_quota.h"
 #include "catalog/catalog.h"
 #include "concurrency/transaction.h"
 #include "storage/page/tmp_tuple_page.h"
@@ -33,10 +34,16 @@ class ExecutorContext {
    * @param bpm The buffer pool manager that the executor uses
    * @param txn_mgr The transaction manager that the executor uses
    * @param lock_mgr The lock manager that the executor uses
+   * @param max_pins How many pages the query may keep pinned at once, 0 for QUERY_PIN_QUOTA_PERCENT of the pool
    */
   ExecutorContext(Transaction *transaction, Catalog *catalog, BufferPoolManager *bpm, TransactionManager *txn_mgr,
-                  LockManager *lock_mgr)
-      : transaction_(transaction), catalog_{catalog}, bpm_{bpm}, txn_mgr_(txn_mgr), lock_mgr_(lock_mgr) {}
+                  LockManager *lock_mgr, size_t max_pins = 0)
+      : transaction_(transaction),
+        catalog_{catalog},
+        bpm_{bpm},
+        txn_mgr_(txn_mgr),
+        lock_mgr_(lock_mgr),
+        pin_quota_(max_pins != 0 ? max_pins : PinQuota::DefaultMaxPins(bpm)) {}
 
   ~ExecutorContext() = default;
 
@@ -60,6 +67,9 @@ class ExecutorContext {
   /** @return the transaction manager */
   TransactionManager *GetTransactionManager() { return txn_mgr_; }
 
+  /** @return the pins of the query, charged while the ExecutionEngine runs it */
+  PinQuota *GetPinQuota() { return &pin_quota_; }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -71,6 +81,8 @@ class ExecutorContext {
   TransactionManager *txn_mgr_;
   /** The lock manager associated with this executor context */
   LockManager *lock_mgr_;
+  /** The pages the query keeps pinned, and how many it may */
+  PinQuota pin_quota_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_io.h
+//
+// Identification: src/include/storage/disk/async_io.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/** Where asynchronous disk I/O runs. */
+enum class AsyncIoBackend {
+  /** io_uring if the kernel allows it, the thread pool otherwise. */
+  AUTO,
+  /** One io_uring: a batch of requests is submitted with a single system call, and no thread waits per request. */
+  IO_URING,
+  /** ASYNC_IO_THREADS threads doing pread and pwrite. */
+  THREAD_POOL
+};
+
+/** One asynchronous read or write, shared by the engine and the handles. */
+struct IoCompletion {
+  bool is_write_;
+  int fd_;
+  std::vector<iovec> iov_;
+  off_t offset_;
+  size_t size_;
+  std::atomic<bool> done_{false};
+  /** Whether the transfer succeeded, valid once done_ is set. */
+  bool ok_{false};
+  /** Called with ok_ once the transfer is over, before done_ is set; may be empty. */
+  std::function<void(bool)> on_complete_;
+};
+
+class AsyncIoEngine;
+
+/**
+ * The completion handle of an asynchronous read or write. A read past the end of the file fills the rest of the
+ * buffer with zeros, like DiskManager::ReadPage.
+ */
+class IoHandle {
+ public:
+  IoHandle() = default;
+
+  /** @return false for a default-constructed handle */
+  bool IsValid() const { return completion_ != nullptr; }
+
+  /** @return true once the transfer is over, without waiting */
+  bool IsDone() const { return completion_->done_.load(std::memory_order_acquire); }
+
+  /**
+   * Wait for the transfer to be over, submitting it first if it was not.
+   * @return false on an I/O error
+   */
+  bool Wait();
+
+ private:
+  friend class AsyncIoEngine;
+
+  IoHandle(AsyncIoEngine *engine, std::shared_ptr<IoCompletion> completion)
+      : engine_(engine), completion_(std::move(completion)) {}
+
+  AsyncIoEngine *engine_{nullptr};
+  std::shared_ptr<IoCompletion> completion_;
+};
+
+/**
+ * Runs reads and writes in the background. Requests are queued by Prepare and started together by Submit, so that a
+ * caller with many pages to move keeps the device queue deep with a single system call. Completions are reaped by
+ * Reap, or by IoHandle::Wait. All calls are thread safe.
+ */
+class AsyncIoEngine {
+ public:
+  /**
+   * @param backend the backend to use; AUTO and IO_URING fall back to the thread pool if io_uring is unavailable
+   * @param queue_depth the size of the io_uring, i.e. the most requests queued or in flight at once on it
+   * @return a new engine
+   */
+  static AsyncIoEngine *Create(AsyncIoBackend backend, size_t queue_depth);
+
+  virtual ~AsyncIoEngine() = default;
+
+  /**
+   * Queue a read or write of the buffers at the given offset of a file. It starts at the next Submit.
+   * @param on_complete called with the outcome once the transfer is over, before the handle shows it as done
+   * @return the completion handle
+   */
+  IoHandle Prepare(bool is_write, int fd, std::vector<iovec> iov, off_t offset,
+                   std::function<void(bool)> on_complete = nullptr);
+
+  /**
+   * Start the queued requests.
+   * @return how many were started
+   */
+  virtual size_t Submit() = 0;
+
+  /**
+   * Wait for requests to complete.
+   * @param min_completions how many to wait for, fewer if fewer are in flight
+   * @return how many completed
+   */
+  virtual size_t Reap(size_t min_completions) = 0;
+
+  /** Submit all queued requests and wait for every request to complete. */
+  void Drain();
+
+  /** @return the backend actually in use, never AUTO */
+  virtual AsyncIoBackend GetBackend() const = 0;
+
+ protected:
+  friend class IoHandle;
+
+  /** Queue a request, see Prepare. */
+  virtual void Enqueue(std::shared_ptr<IoCompletion> completion) = 0;
+
+  /** Wait for a submitted request to complete. */
+  virtual void WaitFor(IoCompletion *completion) = 0;
+
+  /** @return how many requests are queued or in flight */
+  virtual size_t GetNumPending() = 0;
+
+  /**
+   * Finish a request after the given number of bytes were transferred: the rest is transferred synchronously, and a
+   * read past the end of the file is filled with zeros. A negative result is an error.
+   */
+  static void Complete(IoCompletion *completion, ssize_t result);
+};
+
+}  // namespace bustub
@@ -13,28 +13,57 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <fstream>
 #include <future>  // NOLINT
 #include <mutex>   // NOLINT
+#include <shared_mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common/config.h"
+#include "storage/disk/async_io.h"
 
 namespace bustub {
 
+/** How the database file is read and written. The log and the allocation map are always buffered. */
+enum class DiskIoMode {
+  /** Through the OS page cache. */
+  BUFFERED,
+  /**
+   * With O_DIRECT, straight between the buffer and the device, so that pages cached by the buffer pool are not cached
+   * a second time by the OS. Buffers and offsets must be aligned to DIRECT_IO_ALIGNMENT: the frames of the buffer pool
+   * are, other buffers go through an aligned copy. Falls back to BUFFERED if the file system does not support it.
+   */
+  DIRECT
+};
+
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * The database is stored in segment files of a fixed number of pages: page p lives in segment p / segment_pages, at
+ * offset (p % segment_pages) * PAGE_SIZE. Segment 0 is the database file itself, segment n > 0 is the file named
+ * after it with the suffix ".n", next to it or in one of the segment directories. Segments are created on first
+ * write, and a segment other than the first whose pages are all deallocated is unlinked.
  */
 class DiskManager {
  public:
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param async_io_backend where ReadPageAsync and WritePageAsync run
+   * @param io_mode how the database file is read and written
+   * @param segment_pages pages per segment file, a positive multiple of 8
+   * @param segment_dirs directories the segments after the first are spread over in turn, e.g. one per device;
+   * empty to keep them next to the database file
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, AsyncIoBackend async_io_backend = AsyncIoBackend::AUTO,
+                       DiskIoMode io_mode = DiskIoMode::BUFFERED, page_id_t segment_pages = DB_SEGMENT_PAGES,
+                       std::vector<std::string> segment_dirs = {});
 
-  ~DiskManager() = default;
+  ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
@@ -42,12 +71,122 @@ class DiskManager {
   void ShutDown();
 
   /**
-   * Write a page to the database file.
+   * Write a page to the database file. Page reads and writes go straight to the file descriptor at the offset of the
+   * page, without a latch, so that concurrent ones run in parallel on the device.
    * @param page_id id of the page
    * @param page_data raw page data
    */
   void WritePage(page_id_t page_id, const char *page_data);
 
+  /**
+   * Write a run of pages with consecutive ids to the database file, in a single write per segment. Unlike WritePage,
+   * the file is not synced: the caller writes all its runs, then calls Sync once.
+   * @param first_page_id id of the first page of the run
+   * @param pages_data raw data of each page of the run, in page id order
+   * @param num_pages number of pages in the run
+   */
+  void WritePages(page_id_t first_page_id, const char *const *pages_data, size_t num_pages);
+
+  /**
+   * Queue a read of a page. It starts at the next SubmitIo, or when the handle is waited for.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer, must stay valid until the read completes
+   * @return the completion handle
+   */
+  IoHandle ReadPageAsync(page_id_t page_id, char *page_data);
+
+  /**
+   * Queue a write of a page. It starts at the next SubmitIo, or when the handle is waited for. Like WritePages, the
+   * file is not synced.
+   * @param page_id id of the page
+   * @param page_data raw page data, must stay valid and unchanged until the write completes
+   * @return the completion handle
+   */
+  IoHandle WritePageAsync(page_id_t page_id, const char *page_data);
+
+  /**
+   * Queue a single write of a run of pages with consecutive ids, see WritePages and WritePageAsync.
+   * @param first_page_id id of the first page of the run
+   * @param pages_data raw data of each page of the run, in page id order
+   * @param num_pages number of pages in the run, at most IOV_MAX; the run must not cross a segment boundary
+   * @return the completion handle
+   */
+  IoHandle WritePagesAsync(page_id_t first_page_id, const char *const *pages_data, size_t num_pages);
+
+  /**
+   * Start the queued asynchronous reads and writes together.
+   * @return how many were started
+   */
+  size_t SubmitIo();
+
+  /**
+   * Wait for asynchronous reads and writes to complete.
+   * @param min_completions how many to wait for, fewer if fewer are in flight
+   * @return how many completed
+   */
+  size_t ReapIo(size_t min_completions = 1);
+
+  /** @return where the asynchronous reads and writes run */
+  AsyncIoBackend GetAsyncIoBackend();
+
+  /** @return how the database file is actually read and written, BUFFERED if DIRECT was not supported */
+  DiskIoMode GetIoMode() const { return io_mode_; }
+
+  /** @return pages per segment file */
+  page_id_t GetSegmentPages() const { return segment_pages_; }
+
+  /** @return the path of a segment file */
+  std::string GetSegmentPath(size_t segment) const;
+
+  /** Alignment of the buffers and offsets of DIRECT I/O, enough for the logical block size of any device. */
+  static constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
+
+  /**
+   * Sync the database file, making all the page writes so far durable.
+   */
+  void Sync();
+
+  /**
+   * Reserve disk space for a newly allocated page. The segment of the page is extended PREALLOCATE_PAGES pages at a
+   * time, up to its fixed size, so allocating pages does not write them: a page that was never written reads as
+   * zeros.
+   * @param page_id id of the page
+   */
+  void ReservePage(page_id_t page_id);
+
+  /**
+   * Mark a page as in use in the allocation map and reserve its disk space.
+   * @param page_id id of the page, must not be a map page
+   */
+  void AllocatePage(page_id_t page_id);
+
+  /**
+   * Mark a page as free in the allocation map and give its disk space back to the file system, unlinking its whole
+   * segment if no page of it is in use any more. The page reads as zeros until it is written again.
+   * @param page_id id of the page
+   */
+  void DeallocatePage(page_id_t page_id);
+
+  /**
+   * @param page_id id of the page
+   * @return true iff the page is marked as in use in the allocation map
+   */
+  bool IsPageAllocated(page_id_t page_id);
+
+  /**
+   * Read the whole allocation map, e.g. for a buffer pool starting on an existing database to find the page ids that
+   * are free and the first one never handed out.
+   * @param[out] allocated whether each page is in use, up to the last page in use
+   */
+  void GetAllocationMap(std::vector<bool> *allocated);
+
+  /**
+   * Number of pages whose allocation state is kept in one map page. The allocation map lives next to the database
+   * file, in a file of its own: its n-th page holds one bit for each page of the n-th group of PAGES_PER_MAP_PAGE
+   * pages. Map pages are cached in memory and written back by Sync and ShutDown.
+   */
+  static constexpr page_id_t PAGES_PER_MAP_PAGE = PAGE_SIZE * 8;
+
   /**
    * Read a page from the database file.
    * @param page_id id of the page
@@ -69,7 +208,7 @@ class DiskManager {
    * @param offset offset of the log entry in the file
    * @return true if the read was successful, false otherwise
    */
-  bool ReadLog(char *log_data, int size, int offset);
+  bool ReadLog(char *log_data, int size, off_t offset);
 
   /** @return the number of disk flushes */
   int GetNumFlushes() const;
@@ -90,19 +229,98 @@ class DiskManager {
   inline bool HasFlushLogFuture() { return flush_log_f_ != nullptr; }
 
  private:
-  int GetFileSize(const std::string &file_name);
+  /** @return the size of a file on disk, -1 if it does not exist */
+  int64_t GetFileSize(const std::string &file_name) const;
+  /** Record that the db file is now at least end bytes long. */
+  void ExtendFileSize(int64_t end);
+  /** A map page cached in memory. */
+  struct MapPage {
+    char data_[PAGE_SIZE];
+    bool is_dirty_;
+  };
+  /**
+   * Get the map page of the group of a page, reading it from the map file on first use. map_latch_ must be held.
+   * @param page_id id of a page of the group
+   */
+  MapPage *GetMapPage(page_id_t page_id);
+  /** Write the dirty map pages back. map_latch_ must be held. */
+  void WriteMapPages();
+  /** @return the engine of the asynchronous I/O, created on first use */
+  AsyncIoEngine *GetAsyncIo();
+  /** @return true iff the buffer can be handed to the db file as is, i.e. the file is buffered or it is aligned */
+  bool CanTransfer(const char *data) const;
+  /**
+   * Write bytes to a segment file at an aligned offset, through an aligned copy if CanTransfer says so.
+   * @return false on an I/O error
+   */
+  bool WriteAt(int fd, const char *data, size_t size, off_t offset);
+  /**
+   * Read bytes from a segment file at an aligned offset, through an aligned copy if CanTransfer says so.
+   * @return the number of bytes read before the end of the file, -1 on an I/O error
+   */
+  ssize_t ReadAt(int fd, char *data, size_t size, off_t offset);
+  /**
+   * Write a run of pages that lies within one segment, see WritePages.
+   * @return false on an I/O error
+   */
+  bool WriteRun(int fd, off_t offset, const char *const *pages_data, size_t num_pages);
+  /** @return the offset of a page in its segment file */
+  off_t GetSegmentOffset(page_id_t page_id) const { return static_cast<off_t>(page_id % segment_pages_) * PAGE_SIZE; }
+  /**
+   * @param page_id id of a page of the segment
+   * @param create whether to create the segment file if it does not exist
+   * @param[out] segment_lock holds segment_latch_ shared on return, the descriptor stays open until it is released
+   * @return the file descriptor of the segment, -1 if it does not exist and create is false, or on an error
+   */
+  int GetSegmentFd(page_id_t page_id, bool create, std::shared_lock<std::shared_mutex> *segment_lock);
+  /** @return the segments found on disk, with the size of their file */
+  std::vector<std::pair<size_t, int64_t>> FindSegments() const;
+  /** @return true iff no page of the segment is marked as in use. map_latch_ must be held. */
+  bool IsSegmentFree(size_t segment);
+  /** Give the disk space of a segment back by unlinking its file. map_latch_ must be held. */
+  void DropSegment(size_t segment);
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
-  // stream to write db file
-  std::fstream db_io_;
+  // whether the first segment was opened with O_DIRECT
+  DiskIoMode io_mode_;
   std::string file_name_;
+  // pages per segment, and where the segments after the first are
+  const page_id_t segment_pages_;
+  std::vector<std::string> segment_dirs_;
+  // descriptors of the segment files, read and written with pread/pwrite; SEGMENT_NOT_OPEN for a segment file that
+  // is not open yet, SEGMENT_ABSENT for one known not to exist, as are the segments past the end
+  std::vector<int> segment_fds_;
+  static constexpr int SEGMENT_NOT_OPEN = -1;
+  static constexpr int SEGMENT_ABSENT = -2;
+  bool is_shut_down_{false};
+  // protects segment_fds_ and is_shut_down_, held shared while a descriptor is in use; taken after db_io_latch_
+  std::shared_mutex segment_latch_;
+  // bytes of each segment file that are allocated on disk, -1 if not known yet
+  std::vector<int64_t> reserved_sizes_;
+  // size of the db as if its segments were one file, kept in memory so that reads past its end do not touch the
+  // files; it only grows
+  std::atomic<int64_t> file_size_;
+  // size of the log file; the log is written and read by a single thread at a time
+  int64_t log_size_;
   int num_flushes_;
-  int num_writes_;
+  std::atomic<int> num_writes_;
   bool flush_log_;
   std::future<void> *flush_log_f_;
-  // With multiple buffer pool instances, need to protect file access
+  // protects reserved_sizes_, i.e. extending the segments; page reads and writes do not take it
   std::mutex db_io_latch_;
+  // runs the asynchronous page reads and writes, nullptr until the first one
+  AsyncIoBackend async_io_backend_;
+  std::atomic<AsyncIoEngine *> async_io_{nullptr};
+  std::once_flag async_io_once_;
+  // stream to write the allocation map, and the cached map pages indexed by group
+  std::fstream map_io_;
+  std::string map_name_;
+  std::vector<MapPage *> map_pages_;
+  // size of the map file
+  int64_t map_size_;
+  // protects map_io_, map_pages_ and map_size_
+  std::mutex map_latch_;
 };
 
 }  // namespace bustub
@@ -46,7 +46,7 @@ class HashTableBucketPage {
    *
    * @return true if at least one key matched
    */
-  bool GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result);
+  bool GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) const;
 
   /**
    * Attempts to insert a key and value in the bucket.  Uses the occupied_
@@ -127,12 +127,12 @@ class HashTableBucketPage {
   /**
    * @return whether the bucket is full
    */
-  bool IsFull();
+  bool IsFull() const;
 
   /**
    * @return whether the bucket is empty
    */
-  bool IsEmpty();
+  bool IsEmpty() const;
 
   /**
    * Prints the bucket's occupancy information
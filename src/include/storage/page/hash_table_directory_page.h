@@ -63,7 +63,7 @@ class HashTableDirectoryPage {
    * @param bucket_idx the index in the directory to lookup
    * @return bucket page_id corresponding to bucket_idx
    */
-  page_id_t GetBucketPageId(uint32_t bucket_idx);
+  page_id_t GetBucketPageId(uint32_t bucket_idx) const;
 
   /**
    * Updates the directory index using a bucket index and page_id
@@ -95,7 +95,7 @@ class HashTableDirectoryPage {
    *
    * @return mask of global_depth 1's and the rest 0's (with 1's from LSB upwards)
    */
-  uint32_t GetGlobalDepthMask();
+  uint32_t GetGlobalDepthMask() const;
 
   /**
    * GetLocalDepthMask - same as global depth mask, except it
@@ -111,7 +111,7 @@ class HashTableDirectoryPage {
    *
    * @return the global depth of the directory
    */
-  uint32_t GetGlobalDepth();
+  uint32_t GetGlobalDepth() const;
 
   /**
    * Increment the global depth of the directory
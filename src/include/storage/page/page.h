@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
 
@@ -24,14 +25,17 @@ namespace bustub {
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
  * pin count, dirty flag, page id, etc.
+ *
+ * The data itself lives in the frame arena of the buffer pool, so a Page only holds the book-keeping of its frame.
+ * Pages are cache-line aligned, so that updating the book-keeping of one frame never invalidates that of another.
  */
-class Page {
+class alignas(64) Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
   friend class BufferPoolManagerInstance;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
+  /** Constructor. The buffer pool points the page at its data before it is used. */
+  Page() = default;
 
   /** Default destructor. */
   ~Page() = default;
@@ -48,11 +52,22 @@ class Page {
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline bool IsDirty() { return is_dirty_; }
 
+  /** @return how many times the page was pinned since it was brought into this frame */
+  inline uint64_t GetAccessCount() { return access_count_; }
+
   /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  inline void WLatch() {
+    rwlatch_.WLock();
+    // 版本号变为奇数: 有写者在修改页面
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
 
   /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  inline void WUnlatch() {
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    rwlatch_.WUnlock();
+  }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
@@ -60,6 +75,27 @@ class Page {
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
+  /**
+   * Start an optimistic read: the page is read without its latch, then the read is validated with
+   * ValidateOptimisticRead. What was read must not be trusted before it has been validated. The page must be pinned.
+   * @param[out] version the version to validate the read against
+   * @return false if a writer holds the latch, in which case the read should not be attempted
+   */
+  inline bool TryOptimisticRead(uint64_t *version) {
+    *version = version_.load(std::memory_order_acquire);
+    return (*version & 1) == 0;
+  }
+
+  /**
+   * Finish an optimistic read.
+   * @param version the version returned by TryOptimisticRead
+   * @return true iff no writer latched the page since TryOptimisticRead
+   */
+  inline bool ValidateOptimisticRead(uint64_t version) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_.load(std::memory_order_relaxed) == version;
+  }
+
   /** @return the page LSN. */
   inline lsn_t GetLSN() { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
 
@@ -78,16 +114,24 @@ class Page {
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }
 
-  /** The actual data that is stored within a page. */
-  char data_[PAGE_SIZE]{};
-  /** The ID of this page. */
-  page_id_t page_id_ = INVALID_PAGE_ID;
+  /** The actual data that is stored within a page: PAGE_SIZE bytes, PAGE_SIZE aligned. */
+  char *data_{nullptr};
+  /** The ID of this page. Atomic because an evicting thread reads it before it knows which shard latch to take. */
+  std::atomic<page_id_t> page_id_ = INVALID_PAGE_ID;
   /** The pin count of this page. */
   int pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
   bool is_dirty_ = false;
+  /** How many times the page was pinned since it was brought into this frame. */
+  uint64_t access_count_ = 0;
+  /** True while the buffer pool is reading this frame from disk or writing it back, without holding its latch. */
+  bool is_io_in_progress_ = false;
+  /** True if the page was already deallocated when a stale fetch read it into this frame. */
+  bool is_deallocated_ = false;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Bumped when the write latch is taken and again when it is released, odd while a writer holds it. */
+  std::atomic<uint64_t> version_{0};
 };
 
 }  // namespace bustub
@@ -0,0 +1,234 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_guard.h
+//
+// Identification: src/include/storage/page/page_guard.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/config.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+
+/**
+ * BasicPageGuard holds the pin of a page and gives it back when it goes out of scope. The page is unpinned dirty iff
+ * its data was accessed for writing through the guard. It does not latch the page: ReadPageGuard and WritePageGuard
+ * build on it for that, so pinning, latching and their release all happen here.
+ */
+class BasicPageGuard {
+ public:
+  BasicPageGuard() = default;
+
+  /**
+   * Take over the pin of a page.
+   * @param bpm the buffer pool manager the page was pinned in
+   * @param page the pinned page, may be nullptr for an empty guard
+   */
+  BasicPageGuard(BufferPoolManager *bpm, Page *page) : bpm_(bpm), page_(page) {}
+
+  BasicPageGuard(const BasicPageGuard &) = delete;
+  BasicPageGuard &operator=(const BasicPageGuard &) = delete;
+
+  /** Take over the pin of another guard, leaving it empty. */
+  BasicPageGuard(BasicPageGuard &&that) noexcept;
+
+  /** Give back the pin held so far, then take over the pin of another guard, leaving it empty. */
+  BasicPageGuard &operator=(BasicPageGuard &&that) noexcept;
+
+  /** Give back the pin if it has not been dropped yet. */
+  ~BasicPageGuard() { Drop(); }
+
+  /** Unpin the page now. The guard is empty afterwards. */
+  void Drop();
+
+  /** @return true iff the guard holds a page */
+  explicit operator bool() const { return page_ != nullptr; }
+
+  /** @return the id of the guarded page */
+  page_id_t PageId() const { return page_->GetPageId(); }
+
+  /** @return the data of the guarded page, for reading */
+  const char *GetData() const { return page_->GetData(); }
+
+  /** @return the data of the guarded page, for writing: the page is unpinned dirty */
+  char *GetDataMut() {
+    is_dirty_ = true;
+    return page_->GetData();
+  }
+
+  /** @return the data of the guarded page viewed as a T, e.g. a hash table bucket page */
+  template <class T>
+  const T *As() const {
+    return reinterpret_cast<const T *>(GetData());
+  }
+
+  /** @return the data of the guarded page viewed as a T, for writing: the page is unpinned dirty */
+  template <class T>
+  T *AsMut() {
+    return reinterpret_cast<T *>(GetDataMut());
+  }
+
+  /** @return the guarded page viewed as a T that derives from Page, e.g. a TablePage */
+  template <class T>
+  T *PageAs() const {
+    return static_cast<T *>(page_);
+  }
+
+  /** @return the guarded page viewed as a T that derives from Page, for writing: the page is unpinned dirty */
+  template <class T>
+  T *PageAsMut() {
+    is_dirty_ = true;
+    return static_cast<T *>(page_);
+  }
+
+  /** The page was written through a view that does not say so, e.g. PageAs: unpin it dirty. */
+  void MarkDirty() { is_dirty_ = true; }
+
+ private:
+  friend class ReadPageGuard;
+  friend class WritePageGuard;
+
+  BufferPoolManager *bpm_{nullptr};
+  Page *page_{nullptr};
+  bool is_dirty_{false};
+};
+
+/**
+ * ReadPageGuard holds the pin and the read latch of a page, and gives both back when it goes out of scope.
+ */
+class ReadPageGuard {
+ public:
+  ReadPageGuard() = default;
+
+  /**
+   * Take over the pin and the read latch of a page.
+   * @param bpm the buffer pool manager the page was pinned in
+   * @param page the pinned and read-latched page, may be nullptr for an empty guard
+   */
+  ReadPageGuard(BufferPoolManager *bpm, Page *page) : guard_(bpm, page) {}
+
+  ReadPageGuard(const ReadPageGuard &) = delete;
+  ReadPageGuard &operator=(const ReadPageGuard &) = delete;
+  ReadPageGuard(ReadPageGuard &&that) noexcept = default;
+
+  /** Give back the latch and the pin held so far, then take over those of another guard, leaving it empty. */
+  ReadPageGuard &operator=(ReadPageGuard &&that) noexcept;
+
+  /** Give back the latch and the pin if they have not been dropped yet. */
+  ~ReadPageGuard() { Drop(); }
+
+  /** Unlatch and unpin the page now. The guard is empty afterwards. */
+  void Drop();
+
+  /** @return true iff the guard holds a page */
+  explicit operator bool() const { return static_cast<bool>(guard_); }
+
+  /** @return the id of the guarded page */
+  page_id_t PageId() const { return guard_.PageId(); }
+
+  /** @return the data of the guarded page */
+  const char *GetData() const { return guard_.GetData(); }
+
+  /** @return the data of the guarded page viewed as a T, e.g. a hash table bucket page */
+  template <class T>
+  const T *As() const {
+    return guard_.As<T>();
+  }
+
+  /**
+   * @return the guarded page viewed as a T that derives from Page, e.g. a TablePage. Such views are not const
+   * correct, only their read-only methods may be called under a read latch.
+   */
+  template <class T>
+  T *PageAs() const {
+    return guard_.PageAs<T>();
+  }
+
+ private:
+  BasicPageGuard guard_;
+};
+
+/**
+ * WritePageGuard holds the pin and the write latch of a page, and gives both back when it goes out of scope. The page
+ * is unpinned dirty iff its data was accessed for writing through the guard.
+ */
+class WritePageGuard {
+ public:
+  WritePageGuard() = default;
+
+  /**
+   * Take over the pin and the write latch of a page.
+   * @param bpm the buffer pool manager the page was pinned in
+   * @param page the pinned and write-latched page, may be nullptr for an empty guard
+   */
+  WritePageGuard(BufferPoolManager *bpm, Page *page) : guard_(bpm, page) {}
+
+  WritePageGuard(const WritePageGuard &) = delete;
+  WritePageGuard &operator=(const WritePageGuard &) = delete;
+  WritePageGuard(WritePageGuard &&that) noexcept = default;
+
+  /** Give back the latch and the pin held so far, then take over those of another guard, leaving it empty. */
+  WritePageGuard &operator=(WritePageGuard &&that) noexcept;
+
+  /** Give back the latch and the pin if they have not been dropped yet. */
+  ~WritePageGuard() { Drop(); }
+
+  /** Unlatch and unpin the page now. The guard is empty afterwards. */
+  void Drop();
+
+  /** @return true iff the guard holds a page */
+  explicit operator bool() const { return static_cast<bool>(guard_); }
+
+  /** @return the id of the guarded page */
+  page_id_t PageId() const { return guard_.PageId(); }
+
+  /** @return the data of the guarded page, for reading */
+  const char *GetData() const { return guard_.GetData(); }
+
+  /** @return the data of the guarded page, for writing: the page is unpinned dirty */
+  char *GetDataMut() { return guard_.GetDataMut(); }
+
+  /** @return the data of the guarded page viewed as a T, e.g. a hash table bucket page */
+  template <class T>
+  const T *As() const {
+    return guard_.As<T>();
+  }
+
+  /** @return the data of the guarded page viewed as a T, for writing: the page is unpinned dirty */
+  template <class T>
+  T *AsMut() {
+    return guard_.AsMut<T>();
+  }
+
+  /** @return the guarded page viewed as a T that derives from Page, for writing: the page is unpinned dirty */
+  template <class T>
+  T *PageAsMut() {
+    return guard_.PageAsMut<T>();
+  }
+
+  /**
+   * @return the guarded page viewed as a T that derives from Page, without dirtying it. For a write that may not
+   * happen, e.g. an update that can fail: call MarkDirty once the page was written.
+   */
+  template <class T>
+  T *PageAs() const {
+    return guard_.PageAs<T>();
+  }
+
+  /** The page was written through PageAs: unpin it dirty. */
+  void MarkDirty() { guard_.MarkDirty(); }
+
+ private:
+  BasicPageGuard guard_;
+};
+
+}  // namespace bustub
@@ -100,8 +100,14 @@ class TableHeap {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn);
 
-  /** @return the begin iterator of this table */
-  TableIterator Begin(Transaction *txn);
+  /**
+   * @param txn the transaction performing the scan
+   * @param use_buffer_ring true for a bulk read: the scanned pages cycle through a small ring of frames instead of
+   * displacing the working set of the buffer pool
+   * @param read_ahead_pages how many pages the iterator keeps being read ahead of the scan in the background
+   * @return the begin iterator of this table
+   */
+  TableIterator Begin(Transaction *txn, bool use_buffer_ring = false, size_t read_ahead_pages = 0);
 
   /** @return the end iterator of this table */
   TableIterator End();
@@ -13,7 +13,9 @@
 #pragma once
 
 #include <cassert>
+#include <memory>
 
+#include "buffer/buffer_ring.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "storage/table/tuple.h"
@@ -29,10 +31,22 @@ class TableIterator {
   friend class Cursor;
 
  public:
-  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
+  /**
+   * @param table_heap the table to scan
+   * @param rid the tuple the iterator points at
+   * @param txn the transaction performing the scan
+   * @param ring the bulk-read ring the scanned pages are read into, nullptr to go through the whole buffer pool
+   * @param read_ahead_pages how many pages past the current one are read in the background, 0 to read none
+   */
+  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, std::shared_ptr<BufferRing> ring = nullptr,
+                size_t read_ahead_pages = 0);
 
   TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {}
+      : table_heap_(other.table_heap_),
+        tuple_(new Tuple(*other.tuple_)),
+        txn_(other.txn_),
+        ring_(other.ring_),
+        read_ahead_pages_(other.read_ahead_pages_) {}
 
   ~TableIterator() { delete tuple_; }
 
@@ -52,13 +66,21 @@ class TableIterator {
     table_heap_ = other.table_heap_;
     *tuple_ = *other.tuple_;
     txn_ = other.txn_;
+    ring_ = other.ring_;
+    read_ahead_pages_ = other.read_ahead_pages_;
     return *this;
   }
 
  private:
+  /** Ask the buffer pool to read the pages that follow the given page, which the scan has just reached. */
+  void ReadAhead(page_id_t page_id);
+
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  /** Shared by the copies of the iterator, which all belong to the same scan. */
+  std::shared_ptr<BufferRing> ring_;
+  size_t read_ahead_pages_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,408 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_io.cpp
+//
+// Identification: src/storage/disk/async_io.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/async_io.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>  // NOLINT
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+
+#include "common/logger.h"
+
+namespace bustub {
+
+bool IoHandle::Wait() {
+  if (!completion_->done_.load(std::memory_order_acquire)) {
+    engine_->Submit();
+    engine_->WaitFor(completion_.get());
+  }
+  return completion_->ok_;
+}
+
+IoHandle AsyncIoEngine::Prepare(bool is_write, int fd, std::vector<iovec> iov, off_t offset,
+                                std::function<void(bool)> on_complete) {
+  auto completion = std::make_shared<IoCompletion>();
+  completion->is_write_ = is_write;
+  completion->fd_ = fd;
+  completion->size_ = 0;
+  for (const iovec &buffer : iov) {
+    completion->size_ += buffer.iov_len;
+  }
+  completion->iov_ = std::move(iov);
+  completion->offset_ = offset;
+  completion->on_complete_ = std::move(on_complete);
+  Enqueue(completion);
+  return IoHandle(this, std::move(completion));
+}
+
+void AsyncIoEngine::Drain() {
+  Submit();
+  while (GetNumPending() > 0) {
+    Reap(1);
+  }
+}
+
+void AsyncIoEngine::Complete(IoCompletion *completion, ssize_t result) {
+  bool ok = result >= 0;
+  // 没传完的部分同步补上: 短写继续写, 短读继续读到文件末尾, 末尾之后填零
+  size_t skip = ok ? result : 0;
+  off_t offset = completion->offset_;
+  for (const iovec &buffer : completion->iov_) {
+    char *data = static_cast<char *>(buffer.iov_base);
+    size_t done = std::min(skip, buffer.iov_len);
+    skip -= done;
+    while (ok && done < buffer.iov_len) {
+      ssize_t n = completion->is_write_ ? pwrite(completion->fd_, data + done, buffer.iov_len - done, offset + done)
+                                        : pread(completion->fd_, data + done, buffer.iov_len - done, offset + done);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n < 0) {
+        ok = false;
+      } else if (n == 0) {
+        // past the end of the file
+        memset(data + done, 0, buffer.iov_len - done);
+        done = buffer.iov_len;
+      } else {
+        done += n;
+      }
+    }
+    offset += buffer.iov_len;
+  }
+  if (!ok) {
+    LOG_DEBUG("I/O error in an asynchronous %s", completion->is_write_ ? "write" : "read");
+  }
+  completion->ok_ = ok;
+  if (completion->on_complete_) {
+    completion->on_complete_(ok);
+  }
+  completion->done_.store(true, std::memory_order_release);
+}
+
+/**
+ * io_uring through the raw system calls, so that the build does not depend on liburing. Requests are written to the
+ * submission ring under sq_latch_ and started by one io_uring_enter; completions are read from the completion ring
+ * under cq_latch_. At most as many requests as the submission ring holds are pending, so the completion ring, which
+ * is twice as large, never overflows.
+ */
+class IoUringEngine : public AsyncIoEngine {
+ public:
+  /** @return a new engine, nullptr if the kernel does not allow io_uring */
+  static IoUringEngine *Open(size_t queue_depth) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, static_cast<unsigned>(queue_depth), &params));
+    if (ring_fd < 0) {
+      return nullptr;
+    }
+    auto *engine = new IoUringEngine(ring_fd, params);
+    if (engine->sq_ring_ == MAP_FAILED || engine->cq_ring_ == MAP_FAILED || engine->sqes_ == MAP_FAILED) {
+      delete engine;
+      return nullptr;
+    }
+    return engine;
+  }
+
+  ~IoUringEngine() override {
+    if (sq_ring_ != MAP_FAILED && cq_ring_ != MAP_FAILED && sqes_ != MAP_FAILED) {
+      Drain();
+    }
+    if (sqes_ != MAP_FAILED) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != MAP_FAILED) {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+    close(ring_fd_);
+  }
+
+  size_t Submit() override {
+    std::lock_guard<std::mutex> sq_lock(sq_latch_);
+    return SubmitLocked();
+  }
+
+  size_t Reap(size_t min_completions) override {
+    std::lock_guard<std::mutex> cq_lock(cq_latch_);
+    return ReapLocked(min_completions);
+  }
+
+  AsyncIoBackend GetBackend() const override { return AsyncIoBackend::IO_URING; }
+
+ protected:
+  void Enqueue(std::shared_ptr<IoCompletion> completion) override {
+    std::lock_guard<std::mutex> sq_lock(sq_latch_);
+    while (num_pending_.load() >= sq_entries_) {
+      // The ring is full: start what is queued, and make room by reaping.
+      SubmitLocked();
+      Reap(1);
+    }
+    unsigned tail = *sq_tail_;
+    unsigned index = tail & *sq_mask_;
+    io_uring_sqe *sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = completion->is_write_ ? IORING_OP_WRITEV : IORING_OP_READV;
+    sqe->fd = completion->fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(completion->iov_.data());
+    sqe->len = static_cast<uint32_t>(completion->iov_.size());
+    sqe->off = completion->offset_;
+    // The ring holds a reference until the completion is reaped.
+    sqe->user_data = reinterpret_cast<uint64_t>(new std::shared_ptr<IoCompletion>(std::move(completion)));
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    num_unsubmitted_++;
+    num_pending_++;
+  }
+
+  void WaitFor(IoCompletion *completion) override {
+    while (!completion->done_.load(std::memory_order_acquire)) {
+      std::lock_guard<std::mutex> cq_lock(cq_latch_);
+      // Another waiter may have reaped it while we waited for the latch.
+      if (!completion->done_.load(std::memory_order_acquire)) {
+        ReapLocked(1);
+      }
+    }
+  }
+
+  size_t GetNumPending() override { return num_pending_.load(); }
+
+ private:
+  IoUringEngine(int ring_fd, const io_uring_params &params) : ring_fd_(ring_fd), sq_entries_(params.sq_entries) {
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                    IORING_OFF_SQ_RING);
+    cq_ring_ = single_mmap ? sq_ring_
+                           : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                                  IORING_OFF_CQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe *>(
+        mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES));
+    if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+      return;
+    }
+    char *sq = static_cast<char *>(sq_ring_);
+    sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    char *cq = static_cast<char *>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+  }
+
+  /** Start the queued requests. sq_latch_ must be held. */
+  size_t SubmitLocked() {
+    size_t num_submitted = 0;
+    while (num_unsubmitted_ > 0) {
+      int ret = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, num_unsubmitted_, 0, 0, nullptr, 0));
+      if (ret < 0 && (errno == EINTR || errno == EAGAIN || errno == EBUSY)) {
+        if (errno != EINTR) {
+          // Out of kernel resources or completion ring space: make room first.
+          Reap(1);
+        }
+        continue;
+      }
+      if (ret < 0) {
+        LOG_DEBUG("io_uring_enter failed: %s", strerror(errno));
+        break;
+      }
+      num_unsubmitted_ -= ret;
+      num_in_flight_ += ret;
+      num_submitted += ret;
+    }
+    return num_submitted;
+  }
+
+  /** Reap completions, waiting for min_completions of them if that many are in flight. cq_latch_ must be held. */
+  size_t ReapLocked(size_t min_completions) {
+    size_t num_reaped = 0;
+    while (true) {
+      unsigned head = *cq_head_;
+      unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+      for (; head != tail; head++) {
+        io_uring_cqe *cqe = &cqes_[head & *cq_mask_];
+        auto *completion = reinterpret_cast<std::shared_ptr<IoCompletion> *>(cqe->user_data);
+        Complete(completion->get(), cqe->res);
+        delete completion;
+        num_reaped++;
+        num_in_flight_--;
+        num_pending_--;
+      }
+      __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+      if (num_reaped >= min_completions || num_in_flight_.load() <= 0) {
+        return num_reaped;
+      }
+      int ret = static_cast<int>(
+          syscall(__NR_io_uring_enter, ring_fd_, 0, static_cast<unsigned>(1), IORING_ENTER_GETEVENTS, nullptr, 0));
+      if (ret < 0 && errno != EINTR) {
+        LOG_DEBUG("io_uring_enter failed: %s", strerror(errno));
+        return num_reaped;
+      }
+    }
+  }
+
+  int ring_fd_;
+  unsigned sq_entries_;
+  void *sq_ring_{MAP_FAILED};
+  void *cq_ring_{MAP_FAILED};
+  size_t sq_ring_size_;
+  size_t cq_ring_size_;
+  io_uring_sqe *sqes_{static_cast<io_uring_sqe *>(MAP_FAILED)};
+  size_t sqes_size_;
+  unsigned *sq_tail_;
+  unsigned *sq_mask_;
+  unsigned *sq_array_;
+  unsigned *cq_head_;
+  unsigned *cq_tail_;
+  unsigned *cq_mask_;
+  io_uring_cqe *cqes_;
+  /** Requests written to the submission ring but not yet submitted. sq_latch_ protects it. */
+  unsigned num_unsubmitted_{0};
+  /**
+   * Requests submitted but not reaped. It is bumped after io_uring_enter returns, so a reaper may briefly see it
+   * negative.
+   */
+  std::atomic<int64_t> num_in_flight_{0};
+  /** Requests queued or in flight. */
+  std::atomic<size_t> num_pending_{0};
+  /** sq_latch_ may be taken before cq_latch_, never after. */
+  std::mutex sq_latch_;
+  std::mutex cq_latch_;
+};
+
+/**
+ * The fallback where io_uring is unavailable: ASYNC_IO_THREADS threads run the submitted requests with pread and
+ * pwrite. The threads are started by the first Submit.
+ */
+class ThreadPoolEngine : public AsyncIoEngine {
+ public:
+  ~ThreadPoolEngine() override {
+    Drain();
+    {
+      std::lock_guard<std::mutex> lock(latch_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (std::thread &thread : threads_) {
+      thread.join();
+    }
+  }
+
+  size_t Submit() override {
+    size_t num_submitted;
+    {
+      std::lock_guard<std::mutex> lock(latch_);
+      num_submitted = queued_.size();
+      if (num_submitted == 0) {
+        return 0;
+      }
+      for (auto &completion : queued_) {
+        submitted_.push_back(std::move(completion));
+      }
+      queued_.clear();
+      while (threads_.size() < static_cast<size_t>(ASYNC_IO_THREADS)) {
+        threads_.emplace_back([this] { RunWorker(); });
+      }
+    }
+    cv_.notify_all();
+    return num_submitted;
+  }
+
+  size_t Reap(size_t min_completions) override {
+    std::unique_lock<std::mutex> lock(latch_);
+    cv_.wait(lock, [&] { return num_completed_ >= min_completions || num_completed_ == num_pending_; });
+    size_t num_reaped = num_completed_;
+    num_pending_ -= num_completed_;
+    num_completed_ = 0;
+    return num_reaped;
+  }
+
+  AsyncIoBackend GetBackend() const override { return AsyncIoBackend::THREAD_POOL; }
+
+ protected:
+  void Enqueue(std::shared_ptr<IoCompletion> completion) override {
+    std::lock_guard<std::mutex> lock(latch_);
+    queued_.push_back(std::move(completion));
+    num_pending_++;
+  }
+
+  void WaitFor(IoCompletion *completion) override {
+    std::unique_lock<std::mutex> lock(latch_);
+    cv_.wait(lock, [&] { return completion->done_.load(std::memory_order_acquire); });
+  }
+
+  size_t GetNumPending() override {
+    std::lock_guard<std::mutex> lock(latch_);
+    return num_pending_;
+  }
+
+ private:
+  void RunWorker() {
+    std::unique_lock<std::mutex> lock(latch_);
+    while (true) {
+      cv_.wait(lock, [&] { return stop_ || !submitted_.empty(); });
+      if (submitted_.empty()) {
+        return;
+      }
+      std::shared_ptr<IoCompletion> completion = std::move(submitted_.front());
+      submitted_.pop_front();
+      lock.unlock();
+      // Nothing transferred yet, so Complete does the whole transfer.
+      Complete(completion.get(), 0);
+      lock.lock();
+      num_completed_++;
+      cv_.notify_all();
+    }
+  }
+
+  /** Requests prepared but not submitted, and submitted but not started. */
+  std::vector<std::shared_ptr<IoCompletion>> queued_;
+  std::deque<std::shared_ptr<IoCompletion>> submitted_;
+  /** Requests queued or in flight or completed but not reaped, and the completed ones. */
+  size_t num_pending_{0};
+  size_t num_completed_{0};
+  bool stop_{false};
+  std::vector<std::thread> threads_;
+  std::mutex latch_;
+  std::condition_variable cv_;
+};
+
+AsyncIoEngine *AsyncIoEngine::Create(AsyncIoBackend backend, size_t queue_depth) {
+  if (backend != AsyncIoBackend::THREAD_POOL) {
+    IoUringEngine *engine = IoUringEngine::Open(queue_depth);
+    if (engine != nullptr) {
+      return engine;
+    }
+    LOG_DEBUG("io_uring is unavailable, falling back to a thread pool");
+  }
+  return new ThreadPoolEngine();
+}
+
+}  // namespace bustub
@@ -10,13 +10,25 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <dirent.h>
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <mutex>  // NOLINT
+#include <shared_mutex>
 #include <string>
 #include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
 #include "common/exception.h"
 #include "common/logger.h"
@@ -26,13 +38,100 @@ namespace bustub {
 
 static char *buffer_used;
 
+/**
+ * Write all the given bytes at the given offset, resuming short writes
+ * @return false on an I/O error
+ */
+static bool WriteFully(int fd, const char *data, size_t size, off_t offset) {
+  while (size > 0) {
+    ssize_t written = pwrite(fd, data, size, offset);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    size -= written;
+    offset += written;
+  }
+  return true;
+}
+
+/**
+ * Read up to size bytes at the given offset, resuming short reads until the end of the file
+ * @return the number of bytes read, -1 on an I/O error
+ */
+static ssize_t ReadFully(int fd, char *data, size_t size, off_t offset) {
+  size_t read_count = 0;
+  while (read_count < size) {
+    ssize_t n = pread(fd, data + read_count, size - read_count, offset + read_count);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    if (n == 0) {
+      break;
+    }
+    read_count += n;
+  }
+  return read_count;
+}
+
+/**
+ * Allocate a buffer for DIRECT I/O, to be released with free
+ * @param size a multiple of DiskManager::DIRECT_IO_ALIGNMENT
+ */
+static char *AllocateAligned(size_t size) {
+  void *buffer = aligned_alloc(DiskManager::DIRECT_IO_ALIGNMENT, size);
+  if (buffer == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "can't allocate an aligned I/O buffer");
+  }
+  return static_cast<char *>(buffer);
+}
+
+/**
+ * Open a segment file with O_DIRECT if asked to, falling back to buffered I/O on file systems that refuse it
+ * @param[in,out] is_direct whether to use O_DIRECT, false on return if it was refused
+ * @return the file descriptor, -1 if the file can't be opened
+ */
+static int OpenSegmentFile(const std::string &path, int flags, bool *is_direct) {
+  if (*is_direct) {
+    int fd = open(path.c_str(), flags | O_DIRECT, 0644);
+    if (fd >= 0 || errno != EINVAL) {
+      return fd;
+    }
+    // tmpfs等不支持O_DIRECT, 退回到经过page cache的读写
+    LOG_DEBUG("O_DIRECT is not supported for %s, using buffered I/O", path.c_str());
+    *is_direct = false;
+  }
+  return open(path.c_str(), flags, 0644);
+}
+
 /**
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
  // 一个OS文件对应一个database文件，文件中可包含多个数据库概念上的表， 每个表由page串联成一个双向链表
-DiskManager::DiskManager(const std::string &db_file)
-    : file_name_(db_file), num_flushes_(0), num_writes_(0), flush_log_(false), flush_log_f_(nullptr) {
+DiskManager::DiskManager(const std::string &db_file, AsyncIoBackend async_io_backend, DiskIoMode io_mode,
+                         page_id_t segment_pages, std::vector<std::string> segment_dirs)
+    : io_mode_(io_mode),
+      file_name_(db_file),
+      segment_pages_(segment_pages),
+      segment_dirs_(std::move(segment_dirs)),
+      file_size_(0),
+      log_size_(0),
+      num_flushes_(0),
+      num_writes_(0),
+      flush_log_(false),
+      flush_log_f_(nullptr),
+      async_io_backend_(async_io_backend),
+      map_size_(0) {
+  if (segment_pages_ <= 0 || segment_pages_ % 8 != 0) {
+    throw Exception("segment size must be a positive multiple of 8 pages");
+  }
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
@@ -54,30 +153,87 @@ DiskManager::DiskManager(const std::string &db_file)
     }
   }
 
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
+  std::scoped_lock scoped_latches(map_latch_, db_io_latch_);
+  // 第一个segment就是db文件本身, 由它决定是否用O_DIRECT
+  bool is_direct = io_mode_ == DiskIoMode::DIRECT;
+  int db_fd = OpenSegmentFile(db_file, O_RDWR, &is_direct);
+  // the allocation map of a new db file starts empty, whatever a former db file of that name left behind
+  std::ios::openmode map_mode = std::ios::binary | std::ios::in | std::ios::out;
   // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
+  if (db_fd < 0) {
+    map_mode |= std::ios::trunc;
     // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-    db_io_.close();
-    // reopen with original mode
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-    if (!db_io_.is_open()) {
+    db_fd = OpenSegmentFile(db_file, O_RDWR | O_CREAT | O_TRUNC, &is_direct);
+    if (db_fd < 0) {
       throw Exception("can't open db file");
     }
+    // so do its segments
+    for (const auto &segment : FindSegments()) {
+      unlink(GetSegmentPath(segment.first).c_str());
+    }
   }
+  io_mode_ = is_direct ? DiskIoMode::DIRECT : DiskIoMode::BUFFERED;
+  segment_fds_.push_back(db_fd);
+  map_name_ = file_name_.substr(0, n) + ".map";
+  map_io_.open(map_name_, map_mode);
+  if (!map_io_.is_open()) {
+    map_io_.clear();
+    map_io_.open(map_name_, std::ios::binary | std::ios::trunc | std::ios::out);
+    map_io_.close();
+    map_io_.open(map_name_, std::ios::binary | std::ios::in | std::ios::out);
+    if (!map_io_.is_open()) {
+      throw Exception("can't open map file");
+    }
+  }
+  // 文件大小只在这里stat一次, 之后由写和扩展在内存里维护
+  file_size_ = std::max<int64_t>(GetFileSize(db_file), 0);
+  for (const auto &segment : FindSegments()) {
+    ExtendFileSize(static_cast<int64_t>(segment.first) * segment_pages_ * PAGE_SIZE + segment.second);
+    if (segment.first >= segment_fds_.size()) {
+      segment_fds_.resize(segment.first + 1, SEGMENT_ABSENT);
+    }
+    segment_fds_[segment.first] = SEGMENT_NOT_OPEN;
+  }
+  map_size_ = std::max<int64_t>(GetFileSize(map_name_), 0);
+  log_size_ = std::max<int64_t>(GetFileSize(log_name_), 0);
   buffer_used = nullptr;
 }
 
+DiskManager::~DiskManager() {
+  // the engine finishes what is in flight before the files are closed
+  delete async_io_.load();
+  for (int fd : segment_fds_) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+  for (MapPage *map_page : map_pages_) {
+    delete map_page;
+  }
+}
+
 /**
  * Close all file streams
  */
 void DiskManager::ShutDown() {
+  AsyncIoEngine *async_io = async_io_;
+  if (async_io != nullptr) {
+    async_io->Drain();
+  }
   {
-    std::scoped_lock scoped_db_io_latch(db_io_latch_);
-    db_io_.close();
+    std::scoped_lock scoped_latches(map_latch_, db_io_latch_);
+    if (map_io_.is_open()) {
+      WriteMapPages();
+    }
+    map_io_.close();
+    std::unique_lock segment_lock(segment_latch_);
+    for (int &fd : segment_fds_) {
+      if (fd >= 0) {
+        close(fd);
+        fd = SEGMENT_NOT_OPEN;
+      }
+    }
+    is_shut_down_ = true;
   }
   log_io_.close();
 }
@@ -86,47 +242,538 @@ void DiskManager::ShutDown() {
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
-  // set write cursor to offset
   num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
+  ExtendFileSize((static_cast<int64_t>(page_id) + 1) * PAGE_SIZE);
+  std::shared_lock<std::shared_mutex> segment_lock;
+  int fd = GetSegmentFd(page_id, true, &segment_lock);
+  // pwrite goes straight to the kernel, there is no stream buffer to flush
+  if (fd < 0 || !WriteAt(fd, page_data, PAGE_SIZE, GetSegmentOffset(page_id))) {
     LOG_DEBUG("I/O error while writing");
+  }
+}
+
+/**
+ * Write the contents of consecutive pages into disk file, split at segment boundaries, and no sync
+ */
+void DiskManager::WritePages(page_id_t first_page_id, const char *const *pages_data, size_t num_pages) {
+  num_writes_ += 1;
+  ExtendFileSize(static_cast<int64_t>(first_page_id + num_pages) * PAGE_SIZE);
+  size_t num_written = 0;
+  while (num_written < num_pages) {
+    page_id_t page_id = first_page_id + num_written;
+    size_t run_size = std::min<size_t>(num_pages - num_written, segment_pages_ - page_id % segment_pages_);
+    std::shared_lock<std::shared_mutex> segment_lock;
+    int fd = GetSegmentFd(page_id, true, &segment_lock);
+    if (fd < 0 || !WriteRun(fd, GetSegmentOffset(page_id), pages_data + num_written, run_size)) {
+      LOG_DEBUG("I/O error while writing");
+      return;
+    }
+    num_written += run_size;
+  }
+}
+
+/**
+ * Private helper function to write consecutive pages of one segment, one pwritev for up to IOV_MAX pages
+ */
+bool DiskManager::WriteRun(int fd, off_t offset, const char *const *pages_data, size_t num_pages) {
+  if (!std::all_of(pages_data, pages_data + num_pages, [this](const char *data) { return CanTransfer(data); })) {
+    // O_DIRECT下有页不对齐, 整段拷进一块对齐的缓冲区再一次写出
+    char *buffer = AllocateAligned(num_pages * PAGE_SIZE);
+    for (size_t i = 0; i < num_pages; i++) {
+      memcpy(buffer + i * PAGE_SIZE, pages_data[i], PAGE_SIZE);
+    }
+    bool ok = WriteFully(fd, buffer, num_pages * PAGE_SIZE, offset);
+    free(buffer);
+    return ok;
+  }
+  std::vector<iovec> iov;
+  size_t num_written = 0;
+  while (num_written < num_pages) {
+    size_t batch_size = std::min<size_t>(num_pages - num_written, IOV_MAX);
+    iov.resize(batch_size);
+    for (size_t i = 0; i < batch_size; i++) {
+      iov[i].iov_base = const_cast<char *>(pages_data[num_written + i]);
+      iov[i].iov_len = PAGE_SIZE;
+    }
+    off_t batch_offset = offset + static_cast<off_t>(num_written) * PAGE_SIZE;
+    ssize_t written = pwritev(fd, iov.data(), static_cast<int>(batch_size), batch_offset);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written < 0) {
+      return false;
+    }
+    // a short write stops in the middle of a page, finish that page and go on with the next batch
+    size_t pages_written = written / PAGE_SIZE;
+    size_t partial = written % PAGE_SIZE;
+    if (partial != 0) {
+      if (!WriteFully(fd, pages_data[num_written + pages_written] + partial, PAGE_SIZE - partial,
+                      batch_offset + written)) {
+        return false;
+      }
+      pages_written++;
+    }
+    num_written += pages_written;
+  }
+  return true;
+}
+
+/**
+ * Queue a read of the specified page on the asynchronous I/O engine
+ */
+IoHandle DiskManager::ReadPageAsync(page_id_t page_id, char *page_data) {
+  off_t offset = GetSegmentOffset(page_id);
+  // a segment that does not exist yet is created empty, the engine then reads zeros from it
+  std::shared_lock<std::shared_mutex> segment_lock;
+  int fd = GetSegmentFd(page_id, true, &segment_lock);
+  if (CanTransfer(page_data)) {
+    return GetAsyncIo()->Prepare(false, fd, {{page_data, PAGE_SIZE}}, offset);
+  }
+  // read into an aligned copy, handed over to the caller's buffer once the read is over
+  char *buffer = AllocateAligned(PAGE_SIZE);
+  return GetAsyncIo()->Prepare(false, fd, {{buffer, PAGE_SIZE}}, offset, [buffer, page_data](bool ok) {
+    if (ok) {
+      memcpy(page_data, buffer, PAGE_SIZE);
+    }
+    free(buffer);
+  });
+}
+
+/**
+ * Queue a write of the specified page on the asynchronous I/O engine
+ */
+IoHandle DiskManager::WritePageAsync(page_id_t page_id, const char *page_data) {
+  off_t offset = GetSegmentOffset(page_id);
+  num_writes_ += 1;
+  ExtendFileSize((static_cast<int64_t>(page_id) + 1) * PAGE_SIZE);
+  std::shared_lock<std::shared_mutex> segment_lock;
+  int fd = GetSegmentFd(page_id, true, &segment_lock);
+  if (CanTransfer(page_data)) {
+    return GetAsyncIo()->Prepare(true, fd, {{const_cast<char *>(page_data), PAGE_SIZE}}, offset);
+  }
+  char *buffer = AllocateAligned(PAGE_SIZE);
+  memcpy(buffer, page_data, PAGE_SIZE);
+  return GetAsyncIo()->Prepare(true, fd, {{buffer, PAGE_SIZE}}, offset, [buffer](bool) { free(buffer); });
+}
+
+/**
+ * Queue a vectored write of consecutive pages on the asynchronous I/O engine
+ */
+IoHandle DiskManager::WritePagesAsync(page_id_t first_page_id, const char *const *pages_data, size_t num_pages) {
+  assert(num_pages <= IOV_MAX);
+  assert(first_page_id % segment_pages_ + num_pages <= static_cast<size_t>(segment_pages_));
+  off_t offset = GetSegmentOffset(first_page_id);
+  num_writes_ += 1;
+  ExtendFileSize(static_cast<int64_t>(first_page_id + num_pages) * PAGE_SIZE);
+  std::shared_lock<std::shared_mutex> segment_lock;
+  int fd = GetSegmentFd(first_page_id, true, &segment_lock);
+  if (!std::all_of(pages_data, pages_data + num_pages, [this](const char *data) { return CanTransfer(data); })) {
+    char *buffer = AllocateAligned(num_pages * PAGE_SIZE);
+    for (size_t i = 0; i < num_pages; i++) {
+      memcpy(buffer + i * PAGE_SIZE, pages_data[i], PAGE_SIZE);
+    }
+    return GetAsyncIo()->Prepare(true, fd, {{buffer, num_pages * PAGE_SIZE}}, offset,
+                                 [buffer](bool) { free(buffer); });
+  }
+  std::vector<iovec> iov(num_pages);
+  for (size_t i = 0; i < num_pages; i++) {
+    iov[i].iov_base = const_cast<char *>(pages_data[i]);
+    iov[i].iov_len = PAGE_SIZE;
+  }
+  return GetAsyncIo()->Prepare(true, fd, std::move(iov), offset);
+}
+
+size_t DiskManager::SubmitIo() { return GetAsyncIo()->Submit(); }
+
+size_t DiskManager::ReapIo(size_t min_completions) { return GetAsyncIo()->Reap(min_completions); }
+
+AsyncIoBackend DiskManager::GetAsyncIoBackend() { return GetAsyncIo()->GetBackend(); }
+
+/**
+ * Private helper function to create the asynchronous I/O engine on first use, so that a disk manager that never
+ * needs one does not set up an io_uring or start threads
+ */
+AsyncIoEngine *DiskManager::GetAsyncIo() {
+  std::call_once(async_io_once_,
+                 [this] { async_io_ = AsyncIoEngine::Create(async_io_backend_, ASYNC_IO_QUEUE_DEPTH); });
+  return async_io_.load();
+}
+
+/**
+ * Private helper function to tell whether a buffer meets the alignment of O_DIRECT, if the db file uses it
+ */
+bool DiskManager::CanTransfer(const char *data) const {
+  return io_mode_ == DiskIoMode::BUFFERED || reinterpret_cast<uintptr_t>(data) % DIRECT_IO_ALIGNMENT == 0;
+}
+
+/**
+ * Private helper function to write to the db file, through an aligned copy if the buffer can't be used by O_DIRECT
+ */
+bool DiskManager::WriteAt(int fd, const char *data, size_t size, off_t offset) {
+  if (CanTransfer(data)) {
+    return WriteFully(fd, data, size, offset);
+  }
+  char *buffer = AllocateAligned(size);
+  memcpy(buffer, data, size);
+  bool ok = WriteFully(fd, buffer, size, offset);
+  free(buffer);
+  return ok;
+}
+
+/**
+ * Private helper function to read from the db file, through an aligned copy if the buffer can't be used by O_DIRECT
+ */
+ssize_t DiskManager::ReadAt(int fd, char *data, size_t size, off_t offset) {
+  if (CanTransfer(data)) {
+    return ReadFully(fd, data, size, offset);
+  }
+  char *buffer = AllocateAligned(size);
+  ssize_t read_count = ReadFully(fd, buffer, size, offset);
+  if (read_count > 0) {
+    memcpy(data, buffer, read_count);
+  }
+  free(buffer);
+  return read_count;
+}
+
+/**
+ * Make the page writes so far durable
+ */
+void DiskManager::Sync() {
+  {
+    std::scoped_lock scoped_map_latch(map_latch_);
+    WriteMapPages();
+  }
+  std::shared_lock segment_lock(segment_latch_);
+  for (int fd : segment_fds_) {
+    if (fd >= 0 && fdatasync(fd) != 0) {
+      LOG_DEBUG("I/O error while syncing");
+    }
+  }
+}
+
+/**
+ * Set the bit of the specified page in the allocation map, then make sure the page has disk space
+ */
+void DiskManager::AllocatePage(page_id_t page_id) {
+  {
+    std::scoped_lock scoped_map_latch(map_latch_);
+    MapPage *map_page = GetMapPage(page_id);
+    size_t bit = page_id % PAGES_PER_MAP_PAGE;
+    map_page->data_[bit / 8] |= static_cast<char>(1 << (bit % 8));
+    map_page->is_dirty_ = true;
+  }
+  ReservePage(page_id);
+}
+
+/**
+ * Clear the bit of the specified page in the allocation map and punch a hole in place of the page, or unlink its
+ * segment once the segment is empty
+ */
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  {
+    std::scoped_lock scoped_map_latch(map_latch_);
+    MapPage *map_page = GetMapPage(page_id);
+    size_t bit = page_id % PAGES_PER_MAP_PAGE;
+    map_page->data_[bit / 8] &= static_cast<char>(~(1 << (bit % 8)));
+    map_page->is_dirty_ = true;
+    size_t segment = page_id / segment_pages_;
+    // 第一个segment是db文件本身, 保留; 其余的segment整个空了就删掉文件
+    if (segment > 0 && IsSegmentFree(segment)) {
+      DropSegment(segment);
+      return;
+    }
+  }
+  if (static_cast<int64_t>(page_id) * PAGE_SIZE >= file_size_.load(std::memory_order_acquire)) {
     return;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
+  std::shared_lock<std::shared_mutex> segment_lock;
+  int fd = GetSegmentFd(page_id, false, &segment_lock);
+  if (fd < 0) {
+    return;
+  }
+  off_t offset = GetSegmentOffset(page_id);
+  if (fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, offset, PAGE_SIZE) != 0) {
+    // the file system cannot punch holes, zero the page instead
+    static const char zero_page[PAGE_SIZE] = {0};
+    if (!WriteAt(fd, zero_page, PAGE_SIZE, offset)) {
+      LOG_DEBUG("I/O error while writing");
+    }
+  }
 }
 
 /**
- * Read the contents of the specified page into the given memory area
+ * Returns true if the bit of the specified page is set in the allocation map
  */
-void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
+bool DiskManager::IsPageAllocated(page_id_t page_id) {
+  std::scoped_lock scoped_map_latch(map_latch_);
+  MapPage *map_page = GetMapPage(page_id);
+  size_t bit = page_id % PAGES_PER_MAP_PAGE;
+  return (map_page->data_[bit / 8] & (1 << (bit % 8))) != 0;
+}
+
+/**
+ * Returns the bits of the allocation map up to the last page in use
+ */
+void DiskManager::GetAllocationMap(std::vector<bool> *allocated) {
+  std::scoped_lock scoped_map_latch(map_latch_);
+  // 文件里的map page, 加上内存里还没写回的
+  size_t num_groups = std::max<size_t>((map_size_ + PAGE_SIZE - 1) / PAGE_SIZE, map_pages_.size());
+  allocated->assign(num_groups * PAGES_PER_MAP_PAGE, false);
+  for (size_t group = 0; group < num_groups; group++) {
+    MapPage *map_page = GetMapPage(static_cast<page_id_t>(group * PAGES_PER_MAP_PAGE));
+    for (page_id_t bit = 0; bit < PAGES_PER_MAP_PAGE; bit++) {
+      if ((map_page->data_[bit / 8] & (1 << (bit % 8))) != 0) {
+        (*allocated)[group * PAGES_PER_MAP_PAGE + bit] = true;
+      }
+    }
+  }
+  while (!allocated->empty() && !allocated->back()) {
+    allocated->pop_back();
+  }
+}
+
+/**
+ * Private helper function to get the cached map page of the group of a page
+ */
+DiskManager::MapPage *DiskManager::GetMapPage(page_id_t page_id) {
+  size_t group = page_id / PAGES_PER_MAP_PAGE;
+  if (group >= map_pages_.size()) {
+    map_pages_.resize(group + 1, nullptr);
+  }
+  if (map_pages_[group] == nullptr) {
+    // 第一次用到这个group, 从磁盘读入它的map page; 文件里还没有的话就是全零, 即都未分配
+    auto *map_page = new MapPage();
+    size_t offset = group * PAGE_SIZE;
+    if (static_cast<int64_t>(offset) < map_size_) {
+      map_io_.seekg(offset);
+      map_io_.read(map_page->data_, PAGE_SIZE);
+      if (map_io_.gcount() < PAGE_SIZE) {
+        map_io_.clear();
+      }
+    }
+    map_page->is_dirty_ = false;
+    map_pages_[group] = map_page;
+  }
+  return map_pages_[group];
+}
+
+/**
+ * Private helper function to write the dirty map pages back to the map file
+ */
+void DiskManager::WriteMapPages() {
+  for (size_t group = 0; group < map_pages_.size(); group++) {
+    MapPage *map_page = map_pages_[group];
+    if (map_page == nullptr || !map_page->is_dirty_) {
+      continue;
+    }
+    map_io_.seekp(group * PAGE_SIZE);
+    map_io_.write(map_page->data_, PAGE_SIZE);
+    if (map_io_.bad()) {
+      LOG_DEBUG("I/O error while writing map");
+      return;
+    }
+    map_size_ = std::max<int64_t>(map_size_, (group + 1) * PAGE_SIZE);
+    map_page->is_dirty_ = false;
+  }
+  map_io_.flush();
+}
+
+/**
+ * Extend the segment of the specified page in chunks of PREALLOCATE_PAGES pages, but not past the size of a segment,
+ * so that the page has disk space
+ */
+void DiskManager::ReservePage(page_id_t page_id) {
   std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  int offset = page_id * PAGE_SIZE;
-  // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
-    LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    if (db_io_.bad()) {
-      LOG_DEBUG("I/O error while reading");
+  size_t segment = page_id / segment_pages_;
+  if (segment >= reserved_sizes_.size()) {
+    reserved_sizes_.resize(segment + 1, -1);
+  }
+  int64_t end = GetSegmentOffset(page_id) + PAGE_SIZE;
+  if (end <= reserved_sizes_[segment]) {
+    return;
+  }
+  std::shared_lock<std::shared_mutex> segment_lock;
+  int fd = GetSegmentFd(page_id, true, &segment_lock);
+  if (fd < 0) {
+    LOG_DEBUG("I/O error while preallocating");
+    return;
+  }
+  if (reserved_sizes_[segment] < 0) {
+    // 这个segment第一次扩展, 从它现在的大小开始
+    struct stat stat_buf;
+    reserved_sizes_[segment] = fstat(fd, &stat_buf) == 0 ? stat_buf.st_size : 0;
+    if (end <= reserved_sizes_[segment]) {
       return;
     }
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
-      LOG_DEBUG("Read less than a page");
-      db_io_.clear();
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+  }
+  int64_t chunk_size = static_cast<int64_t>(PREALLOCATE_PAGES) * PAGE_SIZE;
+  int64_t new_size = std::min((end + chunk_size - 1) / chunk_size * chunk_size,
+                              static_cast<int64_t>(segment_pages_) * PAGE_SIZE);
+  if (posix_fallocate(fd, reserved_sizes_[segment], new_size - reserved_sizes_[segment]) != 0) {
+    LOG_DEBUG("I/O error while preallocating");
+  } else {
+    reserved_sizes_[segment] = new_size;
+    ExtendFileSize(static_cast<int64_t>(segment) * segment_pages_ * PAGE_SIZE + new_size);
+  }
+}
+
+/**
+ * Private helper function to get the file descriptor of the segment of a page, opening the segment file on first use
+ */
+int DiskManager::GetSegmentFd(page_id_t page_id, bool create, std::shared_lock<std::shared_mutex> *segment_lock) {
+  size_t segment = page_id / segment_pages_;
+  *segment_lock = std::shared_lock(segment_latch_);
+  int fd = segment < segment_fds_.size() ? segment_fds_[segment] : SEGMENT_ABSENT;
+  // 已打开的, 以及已知不存在又不用创建的segment, 共享锁下就有结果
+  if (fd >= 0 || (fd == SEGMENT_ABSENT && !create) || is_shut_down_) {
+    return std::max(fd, -1);
+  }
+  segment_lock->unlock();
+  {
+    std::unique_lock exclusive_lock(segment_latch_);
+    if (segment >= segment_fds_.size()) {
+      segment_fds_.resize(segment + 1, SEGMENT_ABSENT);
+    }
+    fd = segment_fds_[segment];
+    if (!is_shut_down_ && fd < 0 && (create || fd == SEGMENT_NOT_OPEN)) {
+      // 后面的segment不再决定O_DIRECT: 不支持的话照样打开, 对齐的拷贝对buffered的文件也无妨
+      bool is_direct = io_mode_ == DiskIoMode::DIRECT;
+      fd = OpenSegmentFile(GetSegmentPath(segment), O_RDWR | (create ? O_CREAT : 0), &is_direct);
+      segment_fds_[segment] = fd >= 0 ? fd : errno == ENOENT ? SEGMENT_ABSENT : SEGMENT_NOT_OPEN;
+    }
+  }
+  // the segment may have been dropped in between, look again
+  segment_lock->lock();
+  fd = segment < segment_fds_.size() ? segment_fds_[segment] : SEGMENT_ABSENT;
+  return std::max(fd, -1);
+}
+
+/**
+ * Returns the path of a segment file: the db file for the first segment, the db file name suffixed by the segment
+ * number for the others
+ */
+std::string DiskManager::GetSegmentPath(size_t segment) const {
+  if (segment == 0) {
+    return file_name_;
+  }
+  std::string::size_type slash = file_name_.rfind('/');
+  std::string base_name = slash == std::string::npos ? file_name_ : file_name_.substr(slash + 1);
+  std::string dir = slash == std::string::npos ? "" : file_name_.substr(0, slash + 1);
+  if (!segment_dirs_.empty()) {
+    dir = segment_dirs_[(segment - 1) % segment_dirs_.size()] + "/";
+  }
+  return dir + base_name + "." + std::to_string(segment);
+}
+
+/**
+ * Private helper function to list the segments after the first that exist on disk
+ */
+std::vector<std::pair<size_t, int64_t>> DiskManager::FindSegments() const {
+  std::vector<std::pair<size_t, int64_t>> segments;
+  std::string::size_type slash = file_name_.rfind('/');
+  std::string prefix = (slash == std::string::npos ? file_name_ : file_name_.substr(slash + 1)) + ".";
+  // the directories to list, with the prefix of the paths of their files
+  std::vector<std::pair<std::string, std::string>> dirs;
+  if (segment_dirs_.empty()) {
+    std::string db_dir = slash == std::string::npos ? "" : file_name_.substr(0, slash + 1);
+    dirs.emplace_back(db_dir.empty() ? "." : db_dir, db_dir);
+  }
+  for (const std::string &dir : segment_dirs_) {
+    dirs.emplace_back(dir, dir + "/");
+  }
+  for (const auto &dir : dirs) {
+    DIR *dir_stream = opendir(dir.first.c_str());
+    if (dir_stream == nullptr) {
+      continue;
+    }
+    while (dirent *entry = readdir(dir_stream)) {
+      std::string name = entry->d_name;
+      if (name.size() <= prefix.size() || name.size() > prefix.size() + 9 ||
+          name.compare(0, prefix.size(), prefix) != 0 ||
+          name.find_first_not_of("0123456789", prefix.size()) != std::string::npos) {
+        continue;
+      }
+      size_t segment = std::stoul(name.substr(prefix.size()));
+      std::string path = dir.second + name;
+      // the file of a segment that belongs in another directory is not ours
+      if (segment == 0 || path != GetSegmentPath(segment)) {
+        continue;
+      }
+      segments.emplace_back(segment, GetFileSize(path));
+    }
+    closedir(dir_stream);
+  }
+  return segments;
+}
+
+/**
+ * Private helper function to tell whether all the bits of a segment are clear in the allocation map
+ */
+bool DiskManager::IsSegmentFree(size_t segment) {
+  page_id_t end = static_cast<page_id_t>((segment + 1) * segment_pages_);
+  for (page_id_t page_id = static_cast<page_id_t>(segment * segment_pages_); page_id < end;) {
+    MapPage *map_page = GetMapPage(page_id);
+    size_t bit = page_id % PAGES_PER_MAP_PAGE;
+    page_id_t count = std::min<page_id_t>(end - page_id, PAGES_PER_MAP_PAGE - bit);
+    const char *bytes = map_page->data_ + bit / 8;
+    if (std::any_of(bytes, bytes + count / 8, [](char byte) { return byte != 0; })) {
+      return false;
     }
+    page_id += count;
+  }
+  return true;
+}
+
+/**
+ * Private helper function to unlink a segment file and close its descriptor, once the asynchronous requests that may
+ * still use the descriptor are over
+ */
+void DiskManager::DropSegment(size_t segment) {
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  std::unique_lock segment_lock(segment_latch_);
+  if (segment >= segment_fds_.size() || segment_fds_[segment] == SEGMENT_ABSENT) {
+    return;
+  }
+  if (segment_fds_[segment] >= 0) {
+    // 独占锁下没有人再拿到这个描述符, 已经排队的异步读写做完就可以关了
+    AsyncIoEngine *async_io = async_io_;
+    if (async_io != nullptr) {
+      async_io->Drain();
+    }
+    close(segment_fds_[segment]);
+  }
+  segment_fds_[segment] = SEGMENT_ABSENT;
+  if (unlink(GetSegmentPath(segment).c_str()) != 0 && errno != ENOENT) {
+    LOG_DEBUG("I/O error while dropping a segment");
+  }
+  if (segment < reserved_sizes_.size()) {
+    reserved_sizes_[segment] = -1;
+  }
+}
+
+/**
+ * Read the contents of the specified page into the given memory area
+ */
+void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
+  int fd = -1;
+  std::shared_lock<std::shared_mutex> segment_lock;
+  if (static_cast<int64_t>(page_id) * PAGE_SIZE < file_size_.load(std::memory_order_acquire)) {
+    fd = GetSegmentFd(page_id, false, &segment_lock);
+  }
+  if (fd < 0) {
+    // past the end of the file, or in a segment that was never written: nothing to read
+    memset(page_data, 0, PAGE_SIZE);
+    return;
+  }
+  ssize_t read_count = ReadAt(fd, page_data, PAGE_SIZE, GetSegmentOffset(page_id));
+  if (read_count < 0) {
+    LOG_DEBUG("I/O error while reading");
+    read_count = 0;
+  }
+  if (read_count < PAGE_SIZE) {
+    // the page was allocated but never written, or lies past the end of the file
+    memset(page_data + read_count, 0, PAGE_SIZE - read_count);
   }
 }
 
@@ -159,6 +806,7 @@ void DiskManager::WriteLog(char *log_data, int size) {
     LOG_DEBUG("I/O error while writing log");
     return;
   }
+  log_size_ += size;
   // needs to flush to keep disk file in sync
   log_io_.flush();
   flush_log_ = false;
@@ -169,10 +817,9 @@ void DiskManager::WriteLog(char *log_data, int size) {
  * Always read from the beginning and perform sequence read
  * @return: false means already reach the end
  */
-bool DiskManager::ReadLog(char *log_data, int size, int offset) {
-  if (offset >= GetFileSize(log_name_)) {
+bool DiskManager::ReadLog(char *log_data, int size, off_t offset) {
+  if (offset >= log_size_) {
     // LOG_DEBUG("end of log file");
-    // LOG_DEBUG("file size is %d", GetFileSize(log_name_));
     return false;
   }
   log_io_.seekp(offset);
@@ -210,10 +857,19 @@ bool DiskManager::GetFlushState() const { return flush_log_; }
 /**
  * Private helper function to get disk file size
  */
-int DiskManager::GetFileSize(const std::string &file_name) {
+int64_t DiskManager::GetFileSize(const std::string &file_name) const {
   struct stat stat_buf;
   int rc = stat(file_name.c_str(), &stat_buf);
-  return rc == 0 ? static_cast<int>(stat_buf.st_size) : -1;
+  return rc == 0 ? static_cast<int64_t>(stat_buf.st_size) : -1;
+}
+
+/**
+ * Private helper function to grow the in-memory size of the db file after a write or an extension
+ */
+void DiskManager::ExtendFileSize(int64_t end) {
+  int64_t file_size = file_size_.load(std::memory_order_relaxed);
+  while (file_size < end && !file_size_.compare_exchange_weak(file_size, end, std::memory_order_release)) {
+  }
 }
 
 }  // namespace bustub
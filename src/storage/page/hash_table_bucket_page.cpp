@@ -28,7 +28,7 @@ namespace bustub {
 // 注意： 实现的是可重复的key，但是不能有重复的key-value对
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) {
+bool HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) const {
   // 找到在bucket中所有key符合条件的value 并存储在 result中
   for (uint32_t index = 0; index < static_cast<uint32_t>(BUCKET_ARRAY_SIZE); index++) {
     if (IsReadable(index)) {
@@ -156,7 +156,7 @@ void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_BUCKET_TYPE::IsFull() {
+bool HASH_TABLE_BUCKET_TYPE::IsFull() const {
   for (uint32_t index = 0; index < static_cast<uint32_t>(BUCKET_ARRAY_SIZE); index++) {
     // TODO(ljc): 修改成操作字节可能更快？
     if (IsReadable(index)) {
@@ -180,7 +180,7 @@ uint32_t HASH_TABLE_BUCKET_TYPE::NumReadable() {
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_BUCKET_TYPE::IsEmpty() {
+bool HASH_TABLE_BUCKET_TYPE::IsEmpty() const {
   // LOG_DEBUG("EnterIsEmpty..");
   // for (uint32_t index = 0; index < static_cast<uint32_t>(BUCKET_ARRAY_SIZE); index++) {
   //   if (IsReadable(index)) {
@@ -28,9 +28,9 @@ lsn_t HashTableDirectoryPage::GetLSN() const { return lsn_; }
 
 void HashTableDirectoryPage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
 
-uint32_t HashTableDirectoryPage::GetGlobalDepth() { return global_depth_; }
+uint32_t HashTableDirectoryPage::GetGlobalDepth() const { return global_depth_; }
 
-uint32_t HashTableDirectoryPage::GetGlobalDepthMask() {
+uint32_t HashTableDirectoryPage::GetGlobalDepthMask() const {
   // 如果 全局深度为3， 则返回的是 0x00000007, 2^3 - 1
   // 如果 全局深度为2， 则返回的是 0x00000003, 2^2 - 1
   // 如果 全局深度为1， 则返回的是 0x00000001，2^1 - 1
@@ -45,7 +45,7 @@ void HashTableDirectoryPage::IncrGlobalDepth() { ++global_depth_; }
 
 void HashTableDirectoryPage::DecrGlobalDepth() { --global_depth_; }
 
-page_id_t HashTableDirectoryPage::GetBucketPageId(uint32_t bucket_idx) { return bucket_page_ids_[bucket_idx]; }
+page_id_t HashTableDirectoryPage::GetBucketPageId(uint32_t bucket_idx) const { return bucket_page_ids_[bucket_idx]; }
 
 void HashTableDirectoryPage::SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id) {
   bucket_page_ids_[bucket_idx] = bucket_page_id;
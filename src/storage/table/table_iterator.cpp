@@ -11,14 +11,33 @@
 //===----------------------------------------------------------------------===//
 
 #include <cassert>
+#include <utility>
 
 #include "storage/table/table_heap.h"
 
 namespace bustub {
 
-TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn)
-    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn) {
+namespace {
+
+page_id_t NextTablePageId(Page *page) {
+  auto table_page = static_cast<TablePage *>(page);
+  table_page->RLatch();
+  page_id_t next_page_id = table_page->GetNextPageId();
+  table_page->RUnlatch();
+  return next_page_id;
+}
+
+}  // namespace
+
+TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, std::shared_ptr<BufferRing> ring,
+                             size_t read_ahead_pages)
+    : table_heap_(table_heap),
+      tuple_(new Tuple(rid)),
+      txn_(txn),
+      ring_(std::move(ring)),
+      read_ahead_pages_(read_ahead_pages) {
   if (rid.GetPageId() != INVALID_PAGE_ID) {
+    ReadAhead(rid.GetPageId());
     table_heap_->GetTuple(tuple_->rid_, tuple_, txn_);
   }
 }
@@ -35,19 +54,18 @@ Tuple *TableIterator::operator->() {
 // 前置自增运算符重载
 TableIterator &TableIterator::operator++() {
   BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(tuple_->rid_.GetPageId()));
-  cur_page->RLatch();
-  assert(cur_page != nullptr);  // all pages are pinned
+  ReadPageGuard cur_guard = buffer_pool_manager->FetchPageRead(tuple_->rid_.GetPageId(), ring_.get());
+  assert(cur_guard);  // all pages are pinned
+  auto cur_page = cur_guard.PageAs<TablePage>();
 
   RID next_tuple_rid;
   if (!cur_page->GetNextTupleRid(tuple_->rid_,
                                  &next_tuple_rid)) {  // end of this page
     while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
-      cur_page->RUnlatch();
-      buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
-      cur_page = next_page;
-      cur_page->RLatch();
+      // 先拿到下一页, 再释放当前页
+      cur_guard = buffer_pool_manager->FetchPageRead(cur_page->GetNextPageId(), ring_.get());
+      cur_page = cur_guard.PageAs<TablePage>();
+      ReadAhead(cur_page->GetTablePageId());
       if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
         break;
       }
@@ -59,10 +77,17 @@ TableIterator &TableIterator::operator++() {
     table_heap_->GetTuple(tuple_->rid_, tuple_, txn_);
   }
   // release until copy the tuple
-  cur_page->RUnlatch();
-  buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
   return *this;
 }
+
+void TableIterator::ReadAhead(page_id_t page_id) {
+  if (read_ahead_pages_ == 0) {
+    return;
+  }
+  // 从当前页开始沿着链表往后读, 当前页已经在bufferpool中了
+  table_heap_->buffer_pool_manager_->PrefetchPage(page_id, read_ahead_pages_ + 1, &NextTablePageId, ring_);
+}
+
 // 后置自增运算符重载， 有一个临时对象
 TableIterator TableIterator::operator++(int) {
   TableIterator clone(*this);
@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer_test.cpp
+//
+// Identification: test/buffer/arc_replacer_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "buffer/replacer_workload.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(ARCReplacerTest, SampleTest) {
+  ARCReplacer arc_replacer(3, 1);
+
+  // Scenario: load three pages, then access the page in frame 1 again.
+  arc_replacer.RecordLoad(0, 10);
+  arc_replacer.RecordLoad(1, 11);
+  arc_replacer.RecordLoad(2, 12);
+  EXPECT_EQ(0, arc_replacer.Size());
+  arc_replacer.Unpin(0);
+  arc_replacer.Unpin(1);
+  arc_replacer.Unpin(2);
+  arc_replacer.Pin(1);
+  arc_replacer.Unpin(1);
+  EXPECT_EQ(3, arc_replacer.Size());
+
+  // Scenario: pages seen once are evicted first. Bringing one of them back makes T1 bigger.
+  int value;
+  EXPECT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+  arc_replacer.RecordEviction(0, 10);
+  arc_replacer.RecordLoad(0, 10);
+  arc_replacer.Unpin(0);
+  EXPECT_EQ(1, arc_replacer.GetTargetT1Size());
+
+  // Scenario: T1 is at its target, so the victim still comes from it. Once T1 is empty, T2 gives up its least
+  // recently used frame, and bringing that page back shrinks T1 again.
+  EXPECT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  arc_replacer.RecordEviction(2, 12);
+  EXPECT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  arc_replacer.RecordEviction(1, 11);
+  arc_replacer.RecordLoad(1, 11);
+  EXPECT_EQ(0, arc_replacer.GetTargetT1Size());
+
+  // Scenario: pinned frames are not victimized, removed frames leave no ghost behind.
+  EXPECT_EQ(1, arc_replacer.Size());
+  arc_replacer.Remove(0);
+  EXPECT_EQ(0, arc_replacer.Size());
+  EXPECT_FALSE(arc_replacer.Victim(&value));
+  arc_replacer.Unpin(1);
+  EXPECT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  arc_replacer.RecordLoad(0, 10);
+  EXPECT_EQ(0, arc_replacer.GetTargetT1Size());
+}
+
+TEST(ARCReplacerTest, CorrelatedReferenceTest) {
+  ARCReplacer arc_replacer(3, 3);
+
+  // Scenario: the page in frame 1 is pinned again far enough apart and goes to T2. The page in frame 0 is pinned again
+  // right after it was loaded, which is the same access, so it stays in T1.
+  arc_replacer.RecordLoad(1, 11);
+  arc_replacer.RecordLoad(2, 12);
+  arc_replacer.RecordLoad(0, 10);
+  arc_replacer.Pin(1);
+  arc_replacer.Pin(0);
+  for (frame_id_t frame_id = 0; frame_id < 3; frame_id++) {
+    arc_replacer.Unpin(frame_id);
+  }
+
+  int value;
+  EXPECT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  EXPECT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+  EXPECT_TRUE(arc_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+}
+
+TEST(ARCReplacerTest, ScanResistanceTest) {
+  const size_t pool_size = 10;
+  const size_t correlated_window = 4;
+
+  // The hot pages are in T2 before the scan starts, and the scan only ever churns T1: the pins of the tuples of a
+  // page are correlated, however many there are, so a scanned page never reaches T2.
+  for (int tuples_per_page : {1, 3, 16}) {
+    LRUReplacer lru_replacer(pool_size);
+    ARCReplacer arc_replacer(pool_size, correlated_window);
+    size_t lru_hits = CountHits(&lru_replacer, pool_size, tuples_per_page);
+    size_t arc_hits = CountHits(&arc_replacer, pool_size, tuples_per_page);
+    EXPECT_GE(arc_hits, lru_hits + 5 * 99) << tuples_per_page << " tuples per page";
+  }
+}
+
+}  // namespace bustub
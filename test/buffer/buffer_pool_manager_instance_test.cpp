@@ -10,11 +10,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <chrono>  // NOLINT
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
 #include <random>
+#include <sstream>
 #include <string>
 #include <thread>  // NOLINT
 #include <vector>
@@ -492,6 +494,382 @@ TEST(BufferPoolManagerInstanceTest, IsDirty) {
   delete disk_manager;
 }
 
+TEST(BufferPoolManagerInstanceTest, LazyNewPageTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto bpm = new BufferPoolManagerInstance(2, disk_manager);
+
+  // Scenario: new pages are not written to disk, not even when they are evicted clean.
+  page_id_t page_ids[4];
+  for (auto &page_id : page_ids) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    strcpy(page->GetData(), "lost");  // NOLINT
+    EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(0, disk_manager->GetNumWrites());
+
+  // Scenario: a page that was never written reads back as zeros.
+  auto *page = bpm->FetchPage(page_ids[0]);
+  ASSERT_NE(nullptr, page);
+  for (size_t i = 0; i < PAGE_SIZE; i++) {
+    ASSERT_EQ(0, page->GetData()[i]);
+  }
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[0], false));
+
+  remove("test.db");
+  remove("test.log");
+  remove("test.map");
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, DeletedPageReuseTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto bpm = new BufferPoolManagerInstance(4, disk_manager);
+
+  page_id_t page_ids[8];
+  for (auto &page_id : page_ids) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    strcpy(page->GetData(), "stale");  // NOLINT
+    EXPECT_EQ(1, bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: a deleted page is reused, resident or not, and does not show its former content.
+  EXPECT_EQ(1, bpm->DeletePage(page_ids[6]));
+  EXPECT_EQ(1, bpm->DeletePage(page_ids[2]));
+  page_id_t page_id;
+  for (auto expected_page_id : {page_ids[2], page_ids[6]}) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(expected_page_id, page_id);
+    EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+  }
+  for (int i = 0; i < 4; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+  }
+  auto *page = bpm->FetchPage(page_ids[2]);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, page->GetData()[0]);
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[2], false));
+
+  remove("test.db");
+  remove("test.log");
+  remove("test.map");
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, StaleFetchOfDeletedPageTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto bpm = new BufferPoolManagerInstance(3, disk_manager);
+
+  page_id_t page_ids[3];
+  for (auto &page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: a stale fetch reads deleted pages back, one of them stays pinned.
+  EXPECT_EQ(1, bpm->DeletePage(page_ids[1]));
+  EXPECT_EQ(1, bpm->DeletePage(page_ids[2]));
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[1]));
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[1]));
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[1], false));
+  EXPECT_NE(0, bpm->GetPageAccessCount(page_ids[1]));
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[1], false));
+  // The stale copy is dropped with its last pin.
+  EXPECT_EQ(0, bpm->GetPageAccessCount(page_ids[1]));
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[2]));
+
+  // Scenario: the unpinned stale copy is dropped when its id is reused, the pinned one keeps its id until unpinned.
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(page_ids[1], page_id);
+  EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_NE(page_ids[2], page_id);
+  EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[2], false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(page_ids[2], page_id);
+  EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+
+  // Scenario: no frame leaked, all of them can still be pinned at once.
+  EXPECT_EQ(3, bpm->GetNumUnpinnedFrames());
+  for (int i = 0; i < 3; i++) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+  EXPECT_EQ(0, bpm->GetNumUnpinnedFrames());
+
+  remove("test.db");
+  remove("test.log");
+  remove("test.map");
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, DeletedPageReuseAfterRestartTest) {
+  remove("test.db");
+  remove("test.map");
+  page_id_t page_ids[5];
+  {
+    DiskManager disk_manager("test.db");
+    BufferPoolManagerInstance bpm(2, &disk_manager);
+    for (auto &page_id : page_ids) {
+      ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+      EXPECT_EQ(1, bpm.UnpinPage(page_id, false));
+    }
+    EXPECT_EQ(1, bpm.DeletePage(page_ids[3]));
+    bpm.FlushAllPages();
+    disk_manager.ShutDown();
+  }
+
+  // Scenario: after a restart, the ids freed before it are reused first, then allocation goes on past the last page
+  // in use rather than handing live ids out again.
+  DiskManager disk_manager("test.db");
+  BufferPoolManagerInstance bpm(2, &disk_manager);
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+  EXPECT_EQ(page_ids[3], page_id);
+  EXPECT_EQ(1, bpm.UnpinPage(page_id, false));
+  ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+  EXPECT_EQ(page_ids[4] + 1, page_id);
+  EXPECT_EQ(1, bpm.UnpinPage(page_id, false));
+
+  // Scenario: a page allocated before the restart can be deleted, and its id is reused.
+  EXPECT_EQ(1, bpm.DeletePage(page_ids[1]));
+  EXPECT_FALSE(disk_manager.IsPageAllocated(page_ids[1]));
+  ASSERT_NE(nullptr, bpm.NewPage(&page_id));
+  EXPECT_EQ(page_ids[1], page_id);
+  EXPECT_EQ(1, bpm.UnpinPage(page_id, false));
+
+  // Scenario: an instance of a parallel BPM only takes the ids that map to it.
+  EXPECT_EQ(1, bpm.DeletePage(2));
+  EXPECT_EQ(1, bpm.DeletePage(3));
+  BufferPoolManagerInstance odd_instance(2, 2, 1, &disk_manager);
+  ASSERT_NE(nullptr, odd_instance.NewPage(&page_id));
+  EXPECT_EQ(3, page_id);
+  EXPECT_EQ(1, odd_instance.UnpinPage(page_id, false));
+  ASSERT_NE(nullptr, odd_instance.NewPage(&page_id));
+  EXPECT_EQ(7, page_id);
+  EXPECT_EQ(1, odd_instance.UnpinPage(page_id, false));
+
+  disk_manager.ShutDown();
+  remove("test.db");
+  remove("test.log");
+  remove("test.map");
+}
+
+TEST(BufferPoolManagerInstanceTest, StatsTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto bpm = new BufferPoolManagerInstance(2, disk_manager);
+
+  // Scenario: new pages are neither hits nor misses.
+  page_id_t page_ids[3];
+  for (int i = 0; i < 2; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_ids[i]));
+    EXPECT_EQ(1, bpm->UnpinPage(page_ids[i], true));
+  }
+  EXPECT_EQ(0, bpm->GetStats().hits_ + bpm->GetStats().misses_);
+
+  // Scenario: a fetch of a resident page is a hit, and counts as an access of the page.
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[0], false));
+  EXPECT_EQ(1, bpm->GetStats().hits_);
+  EXPECT_EQ(2, bpm->GetPageAccessCount(page_ids[0]));
+  EXPECT_EQ(1, bpm->GetPageAccessCount(page_ids[1]));
+
+  // Scenario: making room evicts the least recently used pages, both dirty, and reading page 1 back is a miss.
+  ASSERT_NE(nullptr, bpm->NewPage(&page_ids[2]));
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[2], false));
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[1]));
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[1], false));
+  BufferPoolStats stats = bpm->GetStats();
+  EXPECT_EQ(1, stats.hits_);
+  EXPECT_EQ(1, stats.misses_);
+  EXPECT_EQ(2, stats.evictions_);
+  EXPECT_EQ(2, stats.write_backs_);
+  EXPECT_EQ(0, stats.pin_waits_);
+  EXPECT_GT(stats.disk_read_ns_, 0);
+  EXPECT_GT(stats.disk_write_ns_, 0);
+  EXPECT_DOUBLE_EQ(0.5, stats.HitRatio());
+  EXPECT_EQ(0, bpm->GetPageAccessCount(page_ids[0]));
+  EXPECT_EQ(1, bpm->GetPageAccessCount(page_ids[1]));
+
+  // Scenario: the dump lists the counters and the resident pages.
+  std::stringstream dump;
+  bpm->DumpStats(dump);
+  EXPECT_NE(std::string::npos, dump.str().find("hits=1 misses=1"));
+  EXPECT_NE(std::string::npos, dump.str().find("page " + std::to_string(page_ids[1]) + ": 1 accesses"));
+
+  remove("test.db");
+  remove("test.log");
+  remove("test.map");
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, WarmUpTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto bpm = new BufferPoolManagerInstance(4, disk_manager);
+
+  page_id_t page_ids[6];
+  for (auto &page_id : page_ids) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    EXPECT_EQ(1, bpm->UnpinPage(page_id, true));
+  }
+  // Pages 2 to 5 are resident, from coldest to hottest: 4, 5, 3, 2.
+  for (int i : {3, 2}) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    EXPECT_EQ(1, bpm->UnpinPage(page_ids[i], false));
+  }
+  EXPECT_TRUE(bpm->DumpResidentPages("test.warmup"));
+  EXPECT_TRUE(bpm->DeletePage(page_ids[5]));
+  bpm->FlushAllPages();
+  delete bpm;
+
+  // Scenario: a restarted pool reads the dumped pages back before serving traffic, except the ones deleted since.
+  bpm = new BufferPoolManagerInstance(4, disk_manager);
+  EXPECT_EQ(3, bpm->WarmUp("test.warmup"));
+  EXPECT_EQ(3, bpm->GetStats().misses_);
+  EXPECT_EQ(0, bpm->GetPageAccessCount(page_ids[5]));
+  char expected[PAGE_SIZE];
+  for (int i = 2; i < 5; i++) {
+    auto *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    snprintf(expected, PAGE_SIZE, "page %d", page_ids[i]);
+    EXPECT_EQ(0, strcmp(expected, page->GetData()));
+    EXPECT_EQ(1, bpm->UnpinPage(page_ids[i], false));
+  }
+  EXPECT_EQ(3, bpm->GetStats().hits_);
+  EXPECT_EQ(3, bpm->GetStats().misses_);
+  delete bpm;
+
+  // Scenario: a smaller pool only reads the hottest pages.
+  bpm = new BufferPoolManagerInstance(2, disk_manager);
+  EXPECT_EQ(2, bpm->WarmUp("test.warmup"));
+  EXPECT_EQ(1, bpm->GetPageAccessCount(page_ids[2]));
+  EXPECT_EQ(1, bpm->GetPageAccessCount(page_ids[3]));
+  EXPECT_EQ(0, bpm->GetPageAccessCount(page_ids[4]));
+  delete bpm;
+
+  // Scenario: a page the traffic already read is skipped, and a full pool evicts nothing for the warm-up.
+  bpm = new BufferPoolManagerInstance(2, disk_manager);
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[3]));
+  EXPECT_EQ(1, bpm->WarmUp("test.warmup"));
+  EXPECT_EQ(1, bpm->GetPageAccessCount(page_ids[2]));
+  EXPECT_EQ(1, bpm->GetPageAccessCount(page_ids[3]));
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[3], false));
+  EXPECT_EQ(0, bpm->WarmUp("test.warmup"));
+  EXPECT_EQ(2, bpm->GetStats().misses_);
+  delete bpm;
+
+  // Scenario: the warm-up runs in the background.
+  bpm = new BufferPoolManagerInstance(4, disk_manager);
+  EXPECT_EQ(3, bpm->WarmUp("test.warmup", true));
+  bpm->WaitForWarmUp();
+  EXPECT_EQ(3, bpm->GetStats().misses_);
+
+  // Scenario: there is nothing to warm up from.
+  EXPECT_EQ(0, bpm->WarmUp("test.nowarmup"));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  remove("test.map");
+  remove("test.warmup");
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, UnpinnedFramesTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto bpm = new BufferPoolManagerInstance(3, disk_manager);
+  EXPECT_EQ(3, bpm->GetNumUnpinnedFrames());
+  EXPECT_EQ(3, bpm->GetNumCleanUnpinnedFrames());
+
+  page_id_t page_ids[3];
+  ASSERT_NE(nullptr, bpm->NewPage(&page_ids[0]));
+  EXPECT_EQ(2, bpm->GetNumUnpinnedFrames());
+  EXPECT_EQ(2, bpm->GetNumCleanUnpinnedFrames());
+
+  // Scenario: an unpinned dirty page can be reused, but only after a write-back.
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[0], true));
+  EXPECT_EQ(3, bpm->GetNumUnpinnedFrames());
+  EXPECT_EQ(2, bpm->GetNumCleanUnpinnedFrames());
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+  EXPECT_EQ(2, bpm->GetNumUnpinnedFrames());
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[0], false));
+  EXPECT_EQ(2, bpm->GetNumUnpinnedFrames());
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[0], false));
+  EXPECT_EQ(3, bpm->GetNumUnpinnedFrames());
+  EXPECT_EQ(2, bpm->GetNumCleanUnpinnedFrames());
+  EXPECT_EQ(1, bpm->FlushPage(page_ids[0]));
+  EXPECT_EQ(3, bpm->GetNumCleanUnpinnedFrames());
+
+  // Scenario: evicting a dirty page and deleting a page keep the counts right.
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[0], true));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_ids[1]));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_ids[2]));
+  EXPECT_EQ(1, bpm->GetNumUnpinnedFrames());
+  EXPECT_EQ(0, bpm->GetNumCleanUnpinnedFrames());
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(0, bpm->GetNumUnpinnedFrames());
+  EXPECT_EQ(1, bpm->UnpinPage(page_id, true));
+  EXPECT_EQ(1, bpm->DeletePage(page_id));
+  EXPECT_EQ(1, bpm->GetNumUnpinnedFrames());
+  EXPECT_EQ(1, bpm->GetNumCleanUnpinnedFrames());
+
+  remove("test.db");
+  remove("test.log");
+  remove("test.map");
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, FrameLayoutTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+
+  // Scenario: frame data is one PAGE_SIZE aligned region, and frame book-keeping never shares a cache line.
+  EXPECT_EQ(0, sizeof(Page) % 64);
+  for (auto policy : {HugePagePolicy::NONE, HugePagePolicy::TRANSPARENT, HugePagePolicy::EXPLICIT}) {
+    auto bpm = new BufferPoolManagerInstance(8, disk_manager, nullptr, ReplacerPolicy::LRU, policy);
+    Page *pages = bpm->GetPages();
+    for (int i = 0; i < 8; i++) {
+      EXPECT_EQ(0, reinterpret_cast<uintptr_t>(pages[i].GetData()) % PAGE_SIZE);
+      EXPECT_EQ(pages[0].GetData() + i * PAGE_SIZE, pages[i].GetData());
+      EXPECT_EQ(0, reinterpret_cast<uintptr_t>(&pages[i]) % 64);
+    }
+    if (policy == HugePagePolicy::NONE) {
+      EXPECT_EQ(HugePagePolicy::NONE, bpm->GetHugePagePolicy());
+    } else {
+      // Without reserved huge pages, an explicit request falls back to transparent huge pages.
+      EXPECT_NE(HugePagePolicy::NONE, bpm->GetHugePagePolicy());
+      EXPECT_EQ(0, reinterpret_cast<uintptr_t>(pages[0].GetData()) % FrameArena::HUGE_PAGE_SIZE);
+    }
+
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, page->GetData()[PAGE_SIZE - 1]);
+    strcpy(page->GetData(), "Hello");  // NOLINT
+    EXPECT_EQ(1, bpm->UnpinPage(page_id, true));
+    EXPECT_EQ(1, bpm->FlushPage(page_id));
+    delete bpm;
+  }
+
+  remove("test.db");
+  remove("test.log");
+  remove("test.map");
+  delete disk_manager;
+}
+
 TEST(BufferPoolManagerInstanceTest, ConcurrencyTest) {
   const int num_threads = 5;
   const int num_runs = 50;
@@ -975,4 +1353,356 @@ TEST(BufferPoolManagerInstanceTest, HardTest_4) {
   }
 }
 
+TEST(BufferPoolManagerInstanceTest, ConcurrentMissTest) {
+  const int num_threads = 8;
+  const int num_pages = 200;
+  const int num_fetches = 2000;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(10, disk_manager);
+
+  page_id_t temp_page_id;
+  for (int i = 0; i < num_pages; i++) {
+    auto *new_page = bpm->NewPage(&temp_page_id);
+    ASSERT_NE(nullptr, new_page);
+    strcpy(new_page->GetData(), std::to_string(temp_page_id).c_str());  // NOLINT
+    EXPECT_EQ(1, bpm->UnpinPage(temp_page_id, true));
+  }
+
+  // Almost every fetch misses, and most victims are dirty, so the threads constantly overlap their reads and
+  // write-backs. Every fetch must still see the content of the page it asked for.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([bpm, tid]() {
+      unsigned int seed = tid;
+      for (int i = 0; i < num_fetches; i++) {
+        page_id_t page_id = rand_r(&seed) % num_pages;
+        auto *page = bpm->FetchPage(page_id);
+        if (page == nullptr) {
+          continue;
+        }
+        EXPECT_EQ(0, std::strcmp(std::to_string(page_id).c_str(), page->GetData()));
+        EXPECT_EQ(1, bpm->UnpinPage(page_id, i % 2 == 0));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  remove("test.db");
+  remove("test.log");
+  remove("test.map");
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, ConcurrentHitTest) {
+  const int num_threads = 8;
+  const int num_pages = 64;
+  const int num_fetches = 5000;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(num_pages, disk_manager);
+
+  page_id_t temp_page_id;
+  for (int i = 0; i < num_pages; i++) {
+    auto *new_page = bpm->NewPage(&temp_page_id);
+    ASSERT_NE(nullptr, new_page);
+    strcpy(new_page->GetData(), std::to_string(temp_page_id).c_str());  // NOLINT
+    EXPECT_EQ(1, bpm->UnpinPage(temp_page_id, true));
+  }
+
+  // Every page is resident, so the threads only ever go through the sharded page table.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([bpm, tid]() {
+      unsigned int seed = tid;
+      for (int i = 0; i < num_fetches; i++) {
+        page_id_t page_id = rand_r(&seed) % num_pages;
+        auto *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(0, std::strcmp(std::to_string(page_id).c_str(), page->GetData()));
+        EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < num_pages; i++) {
+    EXPECT_EQ(0, bpm->GetPages()[i].GetPinCount());
+  }
+
+  remove("test.db");
+  remove("test.log");
+  remove("test.map");
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, ClockReplacerPolicyTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(3, disk_manager, nullptr, ReplacerPolicy::CLOCK);
+
+  page_id_t page_ids[3];
+  for (auto &page_id : page_ids) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    strcpy(page->GetData(), std::to_string(page_id).c_str());  // NOLINT
+  }
+  page_id_t temp_page_id;
+  EXPECT_EQ(nullptr, bpm->NewPage(&temp_page_id));
+
+  // Once a page is unpinned, the clock can evict it; its content must survive the round trip through the disk.
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[1], true));
+  auto *page = bpm->NewPage(&temp_page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(1, bpm->UnpinPage(temp_page_id, false));
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[0], true));
+
+  page = bpm->FetchPage(page_ids[1]);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, std::strcmp(std::to_string(page_ids[1]).c_str(), page->GetData()));
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[1], false));
+
+  remove("test.db");
+  remove("test.log");
+  remove("test.map");
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, ArcReplacerPolicyTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(2, disk_manager, nullptr, ReplacerPolicy::ARC);
+
+  page_id_t page_ids[2];
+  for (auto &page_id : page_ids) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    strcpy(page->GetData(), std::to_string(page_id).c_str());  // NOLINT
+    EXPECT_EQ(1, bpm->UnpinPage(page_id, true));
+  }
+  // Page 0 is accessed twice, so the page accessed only once is evicted to make room for a new page.
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[0], false));
+  page_id_t temp_page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&temp_page_id));
+  EXPECT_EQ(1, bpm->UnpinPage(temp_page_id, false));
+
+  // Both pages come back with their content, the evicted one through the ghost list.
+  for (auto page_id : page_ids) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, std::strcmp(std::to_string(page_id).c_str(), page->GetData()));
+    EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+  }
+
+  remove("test.db");
+  remove("test.log");
+  remove("test.map");
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, BufferRingTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t num_scan_pages = 100;
+  const size_t num_hot_pages = 4;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  std::vector<page_id_t> scan_page_ids(num_scan_pages);
+  for (auto &page_id : scan_page_ids) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+  }
+  // The hot pages are changed in memory but never marked dirty, so they lose their content if they are evicted.
+  std::vector<page_id_t> hot_page_ids(num_hot_pages);
+  for (auto &page_id : hot_page_ids) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    strcpy(page->GetData(), "hot");  // NOLINT
+    EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: a scan through a ring of two frames leaves the rest of the pool alone.
+  BufferRing ring(2);
+  for (int pass = 0; pass < 2; pass++) {
+    for (auto page_id : scan_page_ids) {
+      auto *page = bpm->FetchPageInRing(page_id, &ring);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(page_id, page->GetPageId());
+      EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+    }
+  }
+  for (auto page_id : hot_page_ids) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, std::strcmp("hot", page->GetData()));
+    EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+  }
+
+  // Scenario: a pinned frame of the ring is not recycled, the scan takes another frame instead.
+  auto *pinned_page = bpm->FetchPageInRing(scan_page_ids[0], &ring);
+  ASSERT_NE(nullptr, pinned_page);
+  for (size_t i = 1; i < 4; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPageInRing(scan_page_ids[i], &ring));
+    EXPECT_EQ(1, bpm->UnpinPage(scan_page_ids[i], false));
+  }
+  EXPECT_EQ(scan_page_ids[0], pinned_page->GetPageId());
+  EXPECT_EQ(1, bpm->UnpinPage(scan_page_ids[0], false));
+
+  // Scenario: the same scan without a ring flushes the hot pages out of the pool.
+  for (auto page_id : scan_page_ids) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+  }
+  for (auto page_id : hot_page_ids) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_NE(0, std::strcmp("hot", page->GetData()));
+    EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+  }
+
+  remove("test.db");
+  remove("test.log");
+  remove("test.map");
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, PrefetchTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t num_pages = 30;
+  const size_t num_prefetched_pages = 5;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Chain the pages: every page stores the id of the next one at its start. The head of the chain ends up on disk.
+  std::vector<page_id_t> page_ids(num_pages);
+  for (auto &page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(1, bpm->UnpinPage(page_id, false));
+  }
+  for (size_t i = 0; i < num_pages; i++) {
+    auto *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    *reinterpret_cast<page_id_t *>(page->GetData()) = i + 1 == num_pages ? INVALID_PAGE_ID : page_ids[i + 1];
+    EXPECT_EQ(1, bpm->UnpinPage(page_ids[i], true));
+  }
+  auto is_resident = [bpm](page_id_t page_id) {
+    for (size_t i = 0; i < buffer_pool_size; i++) {
+      if (bpm->GetPages()[i].GetPageId() == page_id) {
+        return true;
+      }
+    }
+    return false;
+  };
+  EXPECT_FALSE(is_resident(page_ids[0]));
+
+  // Scenario: the pages along the chain are read in the background.
+  bpm->PrefetchPage(page_ids[0], num_prefetched_pages,
+                    [](Page *page) { return *reinterpret_cast<page_id_t *>(page->GetData()); });
+  for (size_t i = 0; i < num_prefetched_pages; i++) {
+    for (int attempt = 0; attempt < 1000 && !is_resident(page_ids[i]); attempt++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_TRUE(is_resident(page_ids[i]));
+  }
+  EXPECT_FALSE(is_resident(page_ids[num_prefetched_pages]));
+
+  // Scenario: reading ahead over resident pages is no access to them, only the next page is read in.
+  bpm->PrefetchPage(page_ids[0], num_prefetched_pages + 1,
+                    [](Page *page) { return *reinterpret_cast<page_id_t *>(page->GetData()); });
+  for (int attempt = 0; attempt < 1000 && !is_resident(page_ids[num_prefetched_pages]); attempt++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_TRUE(is_resident(page_ids[num_prefetched_pages]));
+  for (size_t i = 0; i <= num_prefetched_pages; i++) {
+    EXPECT_EQ(1, bpm->GetPageAccessCount(page_ids[i]));
+  }
+
+  // Scenario: the prefetched pages hold what was written to them, and none of them stays pinned, so the whole pool
+  // can be pinned again.
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    Page *page = nullptr;
+    for (int attempt = 0; attempt < 1000 && page == nullptr; attempt++) {
+      page = bpm->FetchPage(page_ids[i]);
+    }
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(page_ids[i + 1], *reinterpret_cast<page_id_t *>(page->GetData()));
+  }
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    EXPECT_EQ(1, bpm->UnpinPage(page_ids[i], false));
+  }
+
+  remove("test.db");
+  remove("test.log");
+  remove("test.map");
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, BackgroundWriterTest) {
+  const size_t buffer_pool_size = 10;
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  BackgroundWriterOptions options;
+  options.interval_ = std::chrono::milliseconds(1);
+  options.max_pages_per_round_ = 2;
+  options.low_watermark_ = 4;
+  options.high_watermark_ = 8;
+
+  // Eight dirty unpinned pages, one dirty pinned page and one clean pinned page.
+  std::vector<Page *> pages(buffer_pool_size);
+  std::vector<page_id_t> page_ids(buffer_pool_size);
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    pages[i] = bpm->NewPage(&page_ids[i]);
+    ASSERT_NE(nullptr, pages[i]);
+  }
+  for (size_t i = 0; i < 8; i++) {
+    EXPECT_EQ(1, bpm->UnpinPage(page_ids[i], true));
+  }
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[8]));
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[8], true));
+
+  // The writer runs between the checks only, so that it does not race with them.
+  auto run_writer = [bpm, &options]() {
+    bpm->StartBackgroundWriter(options);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    bpm->StopBackgroundWriter();
+  };
+  auto count_dirty = [&pages](size_t begin, size_t end) {
+    size_t num_dirty = 0;
+    for (size_t i = begin; i < end; i++) {
+      num_dirty += pages[i]->IsDirty() ? 1 : 0;
+    }
+    return num_dirty;
+  };
+
+  // Scenario: the writer cleans the unpinned pages and leaves the pinned one alone.
+  for (int attempt = 0; attempt < 100 && count_dirty(0, 8) != 0; attempt++) {
+    run_writer();
+  }
+  EXPECT_EQ(0, count_dirty(0, 8));
+  EXPECT_TRUE(pages[8]->IsDirty());
+
+  // Scenario: with six of the eight next victims clean, the writer is above its low watermark and writes nothing.
+  for (size_t i = 0; i < 2; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    EXPECT_EQ(1, bpm->UnpinPage(page_ids[i], true));
+  }
+  run_writer();
+  EXPECT_EQ(2, count_dirty(0, 8));
+
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[8], false));
+  EXPECT_EQ(1, bpm->UnpinPage(page_ids[9], false));
+
+  remove("test.db");
+  remove("test.log");
+  remove("test.map");
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
 #include <cstdio>
 #include <thread>  // NOLINT
 #include <vector>
@@ -19,7 +20,7 @@
 
 namespace bustub {
 
-TEST(ClockReplacerTest, DISABLED_SampleTest) {
+TEST(ClockReplacerTest, SampleTest) {
   ClockReplacer clock_replacer(7);
 
   // Scenario: unpin six elements, i.e. add them to the replacer.
@@ -59,4 +60,64 @@ TEST(ClockReplacerTest, DISABLED_SampleTest) {
   EXPECT_EQ(4, value);
 }
 
+TEST(ClockReplacerTest, ConcurrencyTest) {
+  const int num_threads = 8;
+  const int num_frames = 64;
+  ClockReplacer clock_replacer(num_frames);
+
+  // Every thread owns a disjoint set of frames and keeps pinning and unpinning them. Frame 0 stays unpinned, so a
+  // victim is always there, and the size never leaves its bounds.
+  clock_replacer.Unpin(0);
+  std::atomic<bool> done{false};
+  std::thread sweeper([&clock_replacer, &done]() {
+    frame_id_t frame;
+    while (!done) {
+      size_t size = clock_replacer.Size();
+      ASSERT_GE(size, 1);
+      ASSERT_LE(size, static_cast<size_t>(num_frames));
+      ASSERT_TRUE(clock_replacer.Victim(&frame));
+      clock_replacer.Unpin(frame);
+    }
+  });
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&clock_replacer, tid]() {
+      for (int round = 0; round < 1000; round++) {
+        for (int frame = tid + num_threads; frame < num_frames; frame += num_threads) {
+          clock_replacer.Unpin(frame);
+          clock_replacer.Pin(frame);
+        }
+      }
+      for (int frame = tid; frame < num_frames; frame += num_threads) {
+        clock_replacer.Unpin(frame);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  done = true;
+  sweeper.join();
+  EXPECT_EQ(num_frames, clock_replacer.Size());
+
+  // Concurrent victims must hand out every frame exactly once.
+  std::vector<std::atomic<int>> victimized(num_frames);
+  threads.clear();
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&clock_replacer, &victimized]() {
+      frame_id_t frame;
+      while (clock_replacer.Victim(&frame)) {
+        victimized[frame]++;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, clock_replacer.Size());
+  for (auto &count : victimized) {
+    EXPECT_EQ(1, count);
+  }
+}
+
 }  // namespace bustub
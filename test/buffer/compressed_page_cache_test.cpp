@@ -0,0 +1,203 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache_test.cpp
+//
+// Identification: test/buffer/compressed_page_cache_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/compressed_page_cache.h"
+#include "gtest/gtest.h"
+#include "logging/common.h"
+#include "storage/table/table_heap.h"
+
+// The benchmark is disabled by default. Run it with
+//   ./test/compressed_page_cache_test --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, CodecTest) {
+  std::mt19937 gen(0);
+  char page[PAGE_SIZE];
+  char decompressed[PAGE_SIZE];
+  std::vector<char> compressed;
+
+  // Scenario: a mostly empty page shrinks a lot and comes back intact.
+  memset(page, 0, PAGE_SIZE);
+  snprintf(page, PAGE_SIZE, "header");
+  memset(page + PAGE_SIZE - 300, 'x', 100);
+  for (int i = PAGE_SIZE - 200; i < PAGE_SIZE; i++) {
+    page[i] = static_cast<char>(gen());
+  }
+  ASSERT_TRUE(CompressedPageCache::Compress(page, &compressed));
+  EXPECT_LT(compressed.size(), 300);
+  ASSERT_TRUE(CompressedPageCache::Decompress(compressed, decompressed));
+  EXPECT_EQ(0, memcmp(page, decompressed, PAGE_SIZE));
+
+  // Scenario: random data does not get smaller, so it is not worth caching.
+  for (char &byte : page) {
+    byte = static_cast<char>(gen());
+  }
+  EXPECT_FALSE(CompressedPageCache::Compress(page, &compressed));
+
+  // Scenario: a truncated page is detected.
+  memset(page, 7, PAGE_SIZE);
+  ASSERT_TRUE(CompressedPageCache::Compress(page, &compressed));
+  compressed.pop_back();
+  EXPECT_FALSE(CompressedPageCache::Decompress(compressed, decompressed));
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, CacheTest) {
+  char page[PAGE_SIZE];
+  char data[PAGE_SIZE];
+  std::vector<char> compressed;
+  memset(page, 0, PAGE_SIZE);
+  ASSERT_TRUE(CompressedPageCache::Compress(page, &compressed));
+  // Room for three empty pages.
+  CompressedPageCache cache(compressed.size() * 3);
+
+  for (page_id_t page_id = 0; page_id < 4; page_id++) {
+    memset(page, page_id, PAGE_SIZE);
+    cache.Insert(page_id, page);
+  }
+  // Scenario: the least recently inserted page made room for the last one.
+  EXPECT_FALSE(cache.Lookup(0, data));
+  ASSERT_TRUE(cache.Lookup(2, data));
+  EXPECT_EQ(2, data[PAGE_SIZE - 1]);
+  // Scenario: a page found leaves the cache, and so does an erased one.
+  EXPECT_FALSE(cache.Lookup(2, data));
+  cache.Erase(3);
+  EXPECT_FALSE(cache.Lookup(3, data));
+  EXPECT_EQ(compressed.size(), cache.GetSize());
+
+  CompressedPageCacheStats stats = cache.GetStats();
+  EXPECT_EQ(4, stats.lookups_);
+  EXPECT_EQ(1, stats.hits_);
+  EXPECT_EQ(4, stats.inserts_);
+  EXPECT_EQ(1, stats.evictions_);
+  EXPECT_GT(stats.CompressionRatio(), 10);
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, BufferPoolTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(2, disk_manager);
+  bpm->EnableCompressedCache(64 * PAGE_SIZE);
+
+  page_id_t page_ids[4];
+  for (auto &page_id : page_ids) {
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: the evicted pages are read back from the cache, not from disk.
+  char expected[PAGE_SIZE];
+  for (int i = 0; i < 2; i++) {
+    Page *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    snprintf(expected, PAGE_SIZE, "page %d", page_ids[i]);
+    EXPECT_EQ(0, strcmp(expected, page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  EXPECT_EQ(2, bpm->GetCompressedCacheStats().hits_);
+  EXPECT_EQ(0, bpm->GetStats().disk_read_ns_);
+
+  // Scenario: a deleted page leaves the cache, and its id comes back empty.
+  EXPECT_TRUE(bpm->DeletePage(page_ids[2]));
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(page_ids[2], page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  for (int i = 0; i < 2; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+  Page *page = bpm->FetchPage(page_ids[2]);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, page->GetData()[0]);
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[2], false));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  remove("test.map");
+  delete bpm;
+  delete disk_manager;
+}
+
+/**
+ * Fill a table several times larger than the pool, then scan it a few times, and print the time of both.
+ */
+void RunTableHeapBenchmark(size_t cache_bytes) {
+  const size_t pool_size = 32;
+  const int num_tuples = 10000;
+  const int num_scans = 5;
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  Column col3{"c", TypeId::BIGINT};
+  Column col4{"d", TypeId::BOOLEAN};
+  Column col5{"e", TypeId::VARCHAR, 16};
+  std::vector<Column> cols{col1, col2, col3, col4, col5};
+  Schema schema{cols};
+  Tuple tuple = ConstructTuple(&schema);
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(pool_size, disk_manager);
+  if (cache_bytes > 0) {
+    bpm->EnableCompressedCache(cache_bytes);
+  }
+  auto start = std::chrono::steady_clock::now();
+  auto *table = new TableHeap(bpm, nullptr, nullptr, transaction);
+  for (int i = 0; i < num_tuples; ++i) {
+    RID rid;
+    table->InsertTuple(tuple, &rid, transaction);
+  }
+  double insert_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  size_t num_read = 0;
+  for (int i = 0; i < num_scans; i++) {
+    for (auto iter = table->Begin(transaction); iter != table->End(); ++iter) {
+      num_read++;
+    }
+  }
+  double scan_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  CompressedPageCacheStats cache_stats = bpm->GetCompressedCacheStats();
+  printf("cache_bytes=%-9zu inserts: %.1f ms, scans of %zu tuples: %.1f ms, disk reads: %.1f ms, "
+         "cache hit_ratio=%.3f compression_ratio=%.2f\n",
+         cache_bytes, insert_ms, num_read, scan_ms, bpm->GetStats().disk_read_ns_ / 1e6, cache_stats.HitRatio(),
+         cache_stats.CompressionRatio());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  remove("test.map");
+  delete table;
+  delete bpm;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, DISABLED_TableHeapBenchmark) {
+  RunTableHeapBenchmark(0);
+  RunTableHeapBenchmark(1024 * PAGE_SIZE);
+}
+
+}  // namespace bustub
@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer_test.cpp
+//
+// Identification: test/buffer/lru_k_replacer_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "buffer/replacer_workload.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_k_replacer(7, 2, 1);
+
+  // Scenario: frames 1 and 2 are accessed twice, frames 3 and 4 only once.
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Pin(3);
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Pin(4);
+  lru_k_replacer.Pin(2);
+  for (frame_id_t frame_id = 1; frame_id <= 4; frame_id++) {
+    lru_k_replacer.Unpin(frame_id);
+  }
+  // Unpinning an evictable frame again changes nothing.
+  lru_k_replacer.Unpin(3);
+  EXPECT_EQ(4, lru_k_replacer.Size());
+
+  // Scenario: frames with fewer than K accesses go first, least recently used first. Then the frame whose second
+  // most recent access is the oldest.
+  int value;
+  EXPECT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+  EXPECT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(4, value);
+  EXPECT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  EXPECT_EQ(1, lru_k_replacer.Size());
+
+  // Scenario: a pinned frame is not evictable, a removed frame loses its history.
+  lru_k_replacer.Pin(2);
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+  lru_k_replacer.Unpin(2);
+  lru_k_replacer.Remove(2);
+  EXPECT_EQ(0, lru_k_replacer.Size());
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Pin(5);
+  lru_k_replacer.Unpin(2);
+  lru_k_replacer.Unpin(5);
+  EXPECT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+}
+
+TEST(LRUKReplacerTest, CorrelatedReferenceTest) {
+  LRUKReplacer lru_k_replacer(7, 2, 3);
+
+  // Scenario: frame 1 is accessed three times in a row, which is a single correlated access. Frame 2 is accessed
+  // twice, far enough apart.
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Unpin(1);
+  lru_k_replacer.Unpin(2);
+
+  int value;
+  EXPECT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  EXPECT_TRUE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+}
+
+TEST(LRUKReplacerTest, ScanResistanceTest) {
+  const size_t pool_size = 10;
+  const size_t correlated_window = 4;
+
+  // Under LRU every scan flushes the hot set out of the pool. Under LRU-K the hot pages survive the scans, so every
+  // lookup made after the first scan still hits. That holds as well when a page has more tuples than the window is
+  // long: the burst goes on as long as each tuple comes right after the previous one.
+  for (int tuples_per_page : {3, 16}) {
+    LRUReplacer lru_replacer(pool_size);
+    LRUKReplacer lru_k_replacer(pool_size, 2, correlated_window);
+    size_t lru_hits = CountHits(&lru_replacer, pool_size, tuples_per_page);
+    size_t lru_k_hits = CountHits(&lru_k_replacer, pool_size, tuples_per_page);
+    EXPECT_GE(lru_k_hits, lru_hits + 5 * 99) << tuples_per_page << " tuples per page";
+  }
+}
+
+}  // namespace bustub
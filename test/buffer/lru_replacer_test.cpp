@@ -248,6 +248,25 @@ TEST(LRUReplacerTest, Size) {
   delete lru_replacer;
 }
 
+TEST(LRUReplacerTest, PeekVictims) {
+  LRUReplacer lru_replacer(7);
+  for (frame_id_t frame_id = 1; frame_id <= 5; frame_id++) {
+    lru_replacer.Unpin(frame_id);
+  }
+  lru_replacer.Pin(2);
+
+  // The frames are listed in victim order and stay in the replacer.
+  std::vector<frame_id_t> frame_ids;
+  lru_replacer.PeekVictims(3, &frame_ids);
+  EXPECT_EQ((std::vector<frame_id_t>{1, 3, 4}), frame_ids);
+  EXPECT_EQ(4, lru_replacer.Size());
+  int value;
+  for (frame_id_t frame_id : frame_ids) {
+    lru_replacer.Victim(&value);
+    EXPECT_EQ(frame_id, value);
+  }
+}
+
 TEST(LRUReplacerTest, ConcurrencyTest) {
   const int num_threads = 5;
   const int num_runs = 50;
@@ -10,10 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <sstream>
 #include <random>
 #include <string>
 #include <thread>  // NOLINT
@@ -1049,4 +1051,215 @@ TEST(ParallelBufferPoolManagerTest, RoundRobinNewPage) {
   delete disk_manager;
 }
 
+TEST(ParallelBufferPoolManagerTest, FlushAllPagesCoalesceTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto pool_size = 2;
+  auto num_instances = 4;
+
+  auto *bpm = new ParallelBufferPoolManager(num_instances, pool_size, disk_manager);
+
+  // Consecutive pages live in different instances.
+  page_id_t page_id_temp;
+  for (int i = 0; i < 8; i++) {
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(i, page_id_temp);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", i);
+  }
+
+  // Scenario: pages 4 and 7 are clean, so the dirty pages form the runs [0, 3] and [5, 6].
+  for (int i = 0; i < 8; i++) {
+    EXPECT_TRUE(bpm->UnpinPage(i, i != 4 && i != 7));
+  }
+  int num_writes = disk_manager->GetNumWrites();
+  bpm->FlushAllPages();
+  EXPECT_EQ(num_writes + 2, disk_manager->GetNumWrites());
+
+  char data[PAGE_SIZE];
+  char expected[PAGE_SIZE];
+  for (int i : {0, 1, 2, 3, 5, 6}) {
+    disk_manager->ReadPage(i, data);
+    snprintf(expected, PAGE_SIZE, "page %d", i);
+    EXPECT_EQ(0, strcmp(expected, data));
+  }
+
+  // Scenario: everything is clean now, nothing is written again.
+  num_writes = disk_manager->GetNumWrites();
+  bpm->FlushAllPages();
+  EXPECT_EQ(num_writes, disk_manager->GetNumWrites());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.map");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(ParallelBufferPoolManagerTest, DeletedPageReuseTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto pool_size = 4;
+  auto num_instances = 3;
+
+  auto *bpm = new ParallelBufferPoolManager(num_instances, pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < 9; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(i, page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: deleted pages are handed out again by the instance that owns them, lowest first. The new pages stay
+  // pinned, so the instances freed by the deletes serve the first new pages and every instance serves two in the end.
+  EXPECT_TRUE(bpm->DeletePage(7));
+  EXPECT_TRUE(bpm->DeletePage(1));
+  EXPECT_TRUE(bpm->DeletePage(5));
+  std::vector<page_id_t> new_page_ids;
+  for (int i = 0; i < 6; i++) {
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, page->GetData()[0]);
+    new_page_ids.push_back(page_id_temp);
+  }
+  EXPECT_EQ((std::vector<page_id_t>{1, 5, 7}), std::vector<page_id_t>(new_page_ids.begin(), new_page_ids.begin() + 3));
+  std::sort(new_page_ids.begin(), new_page_ids.end());
+  EXPECT_EQ((std::vector<page_id_t>{1, 5, 7, 9, 10, 11}), new_page_ids);
+  for (page_id_t page_id : new_page_ids) {
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  remove("test.map");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(ParallelBufferPoolManagerTest, StatsTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto pool_size = 2;
+  auto num_instances = 2;
+
+  auto *bpm = new ParallelBufferPoolManager(num_instances, pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < 3; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+  // Scenario: pages 0 and 2 live in instance 0, page 1 in instance 1.
+  for (page_id_t page_id : {0, 1, 2, 2}) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(3, bpm->GetInstanceStats(0).hits_);
+  EXPECT_EQ(1, bpm->GetInstanceStats(1).hits_);
+  EXPECT_EQ(4, bpm->GetStats().hits_);
+  EXPECT_EQ(0, bpm->GetStats().misses_);
+
+  std::stringstream dump;
+  bpm->DumpStats(dump);
+  EXPECT_NE(std::string::npos, dump.str().find("total: hits=4"));
+  EXPECT_NE(std::string::npos, dump.str().find("instance 1: hits=1"));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.map");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(ParallelBufferPoolManagerTest, WarmUpTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto pool_size = 2;
+  auto num_instances = 2;
+
+  auto *bpm = new ParallelBufferPoolManager(num_instances, pool_size, disk_manager);
+  page_id_t page_id_temp;
+  for (int i = 0; i < 4; i++) {
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  EXPECT_TRUE(bpm->DumpResidentPages("test.warmup"));
+  bpm->FlushAllPages();
+  delete bpm;
+
+  // Scenario: every instance reads back its own pages.
+  bpm = new ParallelBufferPoolManager(num_instances, pool_size, disk_manager);
+  EXPECT_EQ(4, bpm->WarmUp("test.warmup", true));
+  bpm->WaitForWarmUp();
+  EXPECT_EQ(2, bpm->GetInstanceStats(0).misses_);
+  EXPECT_EQ(2, bpm->GetInstanceStats(1).misses_);
+  char expected[PAGE_SIZE];
+  for (int i = 0; i < 4; i++) {
+    Page *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    snprintf(expected, PAGE_SIZE, "page %d", i);
+    EXPECT_EQ(0, strcmp(expected, page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+  EXPECT_EQ(4, bpm->GetStats().hits_);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.map");
+  remove("test.warmup.0");
+  remove("test.warmup.1");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(ParallelBufferPoolManagerTest, LoadAwareNewPageTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto pool_size = 2;
+  auto num_instances = 3;
+
+  auto *bpm = new ParallelBufferPoolManager(num_instances, pool_size, disk_manager);
+
+  // Every instance holds one pinned page, then instance 1 gets an unpinned dirty page and instance 2 a clean one.
+  page_id_t page_id_temp;
+  for (int i = 0; i < 3; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(i, page_id_temp);
+  }
+  EXPECT_TRUE(bpm->UnpinPage(1, true));
+  EXPECT_TRUE(bpm->UnpinPage(2, false));
+
+  // Scenario: the instance with the most clean frames goes first, then the one with the most unpinned frames.
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(5, page_id_temp);
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(4, page_id_temp);
+
+  // Scenario: instances 0 and 2 have one free frame each, and are filled before the dirty page is evicted.
+  std::vector<page_id_t> new_page_ids;
+  for (int i = 0; i < 2; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    new_page_ids.push_back(page_id_temp);
+  }
+  std::sort(new_page_ids.begin(), new_page_ids.end());
+  EXPECT_EQ((std::vector<page_id_t>{3, 8}), new_page_ids);
+  int num_writes = disk_manager->GetNumWrites();
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(7, page_id_temp);
+  EXPECT_EQ(num_writes + 1, disk_manager->GetNumWrites());
+
+  // Scenario: once every frame is pinned, NewPage fails.
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.map");
+
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
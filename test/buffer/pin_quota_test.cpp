@@ -0,0 +1,215 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pin_quota_test.cpp
+//
+// Identification: test/buffer/pin_quota_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/pin_quota.h"
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <thread>  // NOLINT
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PinQuotaTest, QuotaTest) {
+  const std::string db_name = "test.db";
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(10, disk_manager);
+  PinQuota quota(2);
+  EXPECT_EQ(PinQuota::DefaultMaxPins(bpm), MIN_QUERY_PIN_QUOTA);
+  EXPECT_EQ(PinQuota::DefaultMaxPins(nullptr), PinQuota::UNLIMITED);
+  auto *small_bpm = new BufferPoolManagerInstance(3, disk_manager);
+  EXPECT_EQ(PinQuota::DefaultMaxPins(small_bpm), 3);
+  delete small_bpm;
+  auto *large_bpm = new BufferPoolManagerInstance(100, disk_manager);
+  EXPECT_EQ(PinQuota::DefaultMaxPins(large_bpm), 25);
+  delete large_bpm;
+
+  // Scenario: pins taken outside of a query are not charged.
+  page_id_t outside_page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&outside_page_id));
+  EXPECT_EQ(nullptr, PinQuota::Current());
+
+  page_id_t page_ids[3];
+  {
+    PinQuota::Scope scope(&quota);
+    EXPECT_EQ(&quota, PinQuota::Current());
+    // Scenario: the quota of two pins is used up, a pin past it still succeeds while the pool has room.
+    ASSERT_NE(nullptr, bpm->NewPage(&page_ids[0]));
+    ASSERT_NE(nullptr, bpm->FetchPage(outside_page_id));
+    EXPECT_EQ(2, quota.GetNumPins());
+    EXPECT_TRUE(quota.IsUsedUp());
+    ASSERT_NE(nullptr, bpm->NewPage(&page_ids[1]));
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+    EXPECT_EQ(4, quota.GetNumPins());
+
+    // Scenario: unpinning gives the pin back.
+    EXPECT_TRUE(bpm->UnpinPage(outside_page_id, false));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[0], false));
+    EXPECT_EQ(2, quota.GetNumPins());
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[0], true));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[1], true));
+    EXPECT_EQ(0, quota.GetNumPins());
+    EXPECT_EQ(4, quota.GetPeakPins());
+
+    // Scenario: unpinning a page pinned before the query started gives nothing back, even while the query holds
+    // other pins.
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+    EXPECT_TRUE(bpm->UnpinPage(outside_page_id, false));
+    EXPECT_EQ(1, quota.GetNumPins());
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[0], false));
+    EXPECT_EQ(0, quota.GetNumPins());
+  }
+  EXPECT_EQ(nullptr, PinQuota::Current());
+
+  // Scenario: outside of the query, the quota no longer applies.
+  for (auto &page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+  EXPECT_EQ(0, quota.GetNumPins());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.map");
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(PinQuotaTest, WaitForFrameTest) {
+  const std::string db_name = "test.db";
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(2, disk_manager);
+  page_id_t page_ids[2];
+  for (auto &page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+
+  // Scenario: outside of a query, a full pool fails right away.
+  page_id_t page_id;
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+
+  // Scenario: a query waits for a frame to be unpinned instead of failing.
+  std::atomic<bool> done{false};
+  Page *new_page = nullptr;
+  std::thread query([&] {
+    PinQuota quota(PinQuota::UNLIMITED);
+    PinQuota::Scope scope(&quota);
+    new_page = bpm->NewPage(&page_id);
+    done = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(done);
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[0], true));
+  query.join();
+  ASSERT_NE(nullptr, new_page);
+  EXPECT_EQ(page_id, new_page->GetPageId());
+
+  // Scenario: a query gives up once FRAME_WAIT_TIMEOUT_MS passed.
+  {
+    PinQuota quota(PinQuota::UNLIMITED);
+    PinQuota::Scope scope(&quota);
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(FRAME_WAIT_TIMEOUT_MS));
+    EXPECT_EQ(0, quota.GetNumPins());
+  }
+
+  // Scenario: a pin past the quota fails right away instead of waiting.
+  {
+    PinQuota quota(0);
+    PinQuota::Scope scope(&quota);
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(nullptr, bpm->FetchPage(page_ids[0]));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(FRAME_WAIT_TIMEOUT_MS));
+    EXPECT_EQ(0, quota.GetNumPins());
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.map");
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(PinQuotaTest, ParallelWaitForFrameTest) {
+  const std::string db_name = "test.db";
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(2, 1, disk_manager);
+  page_id_t page_ids[2];
+  for (auto &page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+
+  // Scenario: a query waits for a frame of any instance to be unpinned.
+  page_id_t page_id;
+  Page *new_page = nullptr;
+  std::thread query([&] {
+    PinQuota quota(PinQuota::UNLIMITED);
+    PinQuota::Scope scope(&quota);
+    new_page = bpm->NewPage(&page_id);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_TRUE(bpm->UnpinPage(page_ids[1], true));
+  query.join();
+  ASSERT_NE(nullptr, new_page);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.map");
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(PinQuotaTest, AdmissionTest) {
+  AdmissionController admission(10);
+  PinQuota quota1(6);
+  PinQuota quota2(6);
+  PinQuota unlimited(PinQuota::UNLIMITED);
+
+  // Scenario: a query whose quota does not fit queues until the running one leaves.
+  admission.Admit(quota1);
+  std::atomic<bool> admitted{false};
+  std::thread query([&] {
+    AdmissionController::Ticket ticket(&admission, &quota2);
+    admitted = true;
+  });
+  while (admission.GetNumQueued() == 0) {
+    std::this_thread::yield();
+  }
+  EXPECT_FALSE(admitted);
+  EXPECT_EQ(1, admission.GetNumAdmitted());
+  admission.Leave(quota1);
+  query.join();
+  EXPECT_TRUE(admitted);
+  EXPECT_EQ(0, admission.GetNumAdmitted());
+  EXPECT_EQ(0, admission.GetNumQueued());
+
+  // Scenario: a single query is admitted whatever its quota, and small ones fit next to each other.
+  admission.Admit(unlimited);
+  admission.Leave(unlimited);
+  PinQuota small(3);
+  admission.Admit(small);
+  admission.Admit(quota1);
+  EXPECT_EQ(2, admission.GetNumAdmitted());
+  admission.Leave(small);
+  admission.Leave(quota1);
+}
+
+}  // namespace bustub
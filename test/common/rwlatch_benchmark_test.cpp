@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// rwlatch_benchmark_test.cpp
+//
+// Identification: test/common/rwlatch_benchmark_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdio>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/rwlatch.h"
+#include "gtest/gtest.h"
+
+// The benchmarks are disabled by default. Run them with
+//   ./test/rwlatch_benchmark_test --gtest_also_run_disabled_tests
+
+namespace bustub {
+
+/**
+ * The former ReaderWriterLatch, one mutex and two condition variables, kept as the baseline of the benchmarks.
+ */
+class CondVarReaderWriterLatch {
+  static const uint32_t MAX_READERS = UINT32_MAX;
+
+ public:
+  void WLock() {
+    std::unique_lock<std::mutex> latch(mutex_);
+    while (writer_entered_) {
+      reader_.wait(latch);
+    }
+    writer_entered_ = true;
+    while (reader_count_ > 0) {
+      writer_.wait(latch);
+    }
+  }
+
+  void WUnlock() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    writer_entered_ = false;
+    reader_.notify_all();
+  }
+
+  void RLock() {
+    std::unique_lock<std::mutex> latch(mutex_);
+    while (writer_entered_ || reader_count_ == MAX_READERS) {
+      reader_.wait(latch);
+    }
+    reader_count_++;
+  }
+
+  void RUnlock() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    reader_count_--;
+    if (writer_entered_) {
+      if (reader_count_ == 0) {
+        writer_.notify_one();
+      }
+    } else {
+      if (reader_count_ == MAX_READERS - 1) {
+        reader_.notify_one();
+      }
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable writer_;
+  std::condition_variable reader_;
+  uint32_t reader_count_{0};
+  bool writer_entered_{false};
+};
+
+/**
+ * Run num_threads threads that take the latch for a short critical section, one operation in write_every being a
+ * write, and print the throughput.
+ */
+template <class Latch>
+void RunLatchBenchmark(const char *name, int write_every) {
+  const int num_threads = std::max(4U, std::thread::hardware_concurrency());
+  const auto duration = std::chrono::milliseconds(500);
+  Latch latch;
+  uint64_t shared_counter = 0;
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> total_ops{0};
+  // what the readers read, so that the reads are not optimized away
+  std::atomic<uint64_t> checksum{0};
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid]() {
+      uint64_t ops = 0;
+      uint64_t sink = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        if (write_every > 0 && (ops + tid) % write_every == 0) {
+          latch.WLock();
+          shared_counter++;
+          latch.WUnlock();
+        } else {
+          latch.RLock();
+          sink += shared_counter;
+          latch.RUnlock();
+        }
+        ops++;
+      }
+      total_ops += ops;
+      checksum += sink;
+    });
+  }
+  std::this_thread::sleep_for(duration);
+  stop = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  double mops = static_cast<double>(total_ops) / std::chrono::duration<double>(duration).count() / 1e6;
+  printf("%-28s threads=%d write_every=%d: %.2f Mops/s\n", name, num_threads, write_every, mops);
+}
+
+// NOLINTNEXTLINE
+TEST(RWLatchBenchmark, DISABLED_ReaderHeavyTest) {
+  RunLatchBenchmark<CondVarReaderWriterLatch>("CondVarReaderWriterLatch", 0);
+  RunLatchBenchmark<ReaderWriterLatch>("ReaderWriterLatch", 0);
+  RunLatchBenchmark<CondVarReaderWriterLatch>("CondVarReaderWriterLatch", 100);
+  RunLatchBenchmark<ReaderWriterLatch>("ReaderWriterLatch", 100);
+}
+
+// NOLINTNEXTLINE
+TEST(RWLatchBenchmark, DISABLED_MixedTest) {
+  RunLatchBenchmark<CondVarReaderWriterLatch>("CondVarReaderWriterLatch", 10);
+  RunLatchBenchmark<ReaderWriterLatch>("ReaderWriterLatch", 10);
+  RunLatchBenchmark<CondVarReaderWriterLatch>("CondVarReaderWriterLatch", 2);
+  RunLatchBenchmark<ReaderWriterLatch>("ReaderWriterLatch", 2);
+}
+
+}  // namespace bustub
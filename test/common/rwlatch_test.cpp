@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -57,4 +58,41 @@ TEST(RWLatchTest, BasicTest) {
   }
   EXPECT_EQ(counter.Read(), 55);
 }
+// NOLINTNEXTLINE
+TEST(RWLatchTest, ExclusionTest) {
+  const int num_threads = 8;
+  const int num_rounds = 2000;
+  ReaderWriterLatch latch;
+  std::atomic<int> readers{0};
+  std::atomic<int> writers{0};
+  std::atomic<bool> violated{false};
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid]() {
+      for (int round = 0; round < num_rounds; round++) {
+        // One operation in four is a write.
+        if ((tid + round) % 4 == 0) {
+          latch.WLock();
+          if (writers.fetch_add(1) != 0 || readers.load() != 0) {
+            violated = true;
+          }
+          writers.fetch_sub(1);
+          latch.WUnlock();
+        } else {
+          latch.RLock();
+          readers.fetch_add(1);
+          if (writers.load() != 0) {
+            violated = true;
+          }
+          readers.fetch_sub(1);
+          latch.RUnlock();
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(violated);
+}
 }  // namespace bustub
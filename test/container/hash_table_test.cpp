@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -186,4 +187,104 @@ TEST(HashTableTest, DIYTEST) {
   delete disk_manager;
   delete bpm;
 }
+// NOLINTNEXTLINE
+TEST(HashTableTest, OptimisticReadConcurrencyTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  const int num_keys = 2000;
+  for (int i = 0; i < num_keys; i += 2) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+
+  // The readers look the even keys up while the writer splits and merges buckets with the odd keys.
+  std::atomic<bool> done{false};
+  std::thread writer([&ht, &done] {
+    for (int round = 0; round < 3; round++) {
+      for (int i = 1; i < num_keys; i += 2) {
+        ht.Insert(nullptr, i, i);
+      }
+      for (int i = 1; i < num_keys; i += 2) {
+        ht.Remove(nullptr, i, i);
+      }
+    }
+    done = true;
+  });
+  std::vector<std::thread> readers;
+  for (int tid = 0; tid < 3; tid++) {
+    readers.emplace_back([&ht, &done] {
+      while (!done) {
+        for (int i = 0; i < num_keys; i += 2) {
+          std::vector<int> res;
+          ht.GetValue(nullptr, i, &res);
+          ASSERT_EQ(1, res.size()) << "Failed to find " << i;
+          ASSERT_EQ(i, res[0]);
+        }
+      }
+    });
+  }
+  writer.join();
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  ht.VerifyIntegrity();
+  // Buckets the readers read back after a merge deleted them did not leak their frames.
+  page_id_t page_id;
+  for (int i = 0; i < 50; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.map");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, MergePinnedBucketTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // The first split leaves the directory (page 0) with two buckets.
+  int num_keys = 0;
+  while (ht.GetGlobalDepth() == 0) {
+    EXPECT_TRUE(ht.Insert(nullptr, num_keys, num_keys));
+    num_keys++;
+  }
+  auto *dir_page = reinterpret_cast<HashTableDirectoryPage *>(bpm->FetchPage(0)->GetData());
+  page_id_t bucket_page_ids[2] = {dir_page->GetBucketPageId(0), dir_page->GetBucketPageId(1)};
+  bpm->UnpinPage(0, false);
+
+  // Scenario: the buckets are pinned as by a lock-free reader while the merge takes one of them away.
+  for (page_id_t bucket_page_id : bucket_page_ids) {
+    ASSERT_NE(nullptr, bpm->FetchPage(bucket_page_id));
+  }
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+  dir_page = reinterpret_cast<HashTableDirectoryPage *>(bpm->FetchPage(0)->GetData());
+  page_id_t merged_page_id =
+      dir_page->GetBucketPageId(0) == bucket_page_ids[0] ? bucket_page_ids[1] : bucket_page_ids[0];
+  bpm->UnpinPage(0, false);
+  EXPECT_TRUE(disk_manager->IsPageAllocated(merged_page_id));
+  for (page_id_t bucket_page_id : bucket_page_ids) {
+    EXPECT_TRUE(bpm->UnpinPage(bucket_page_id, false));
+  }
+
+  // Scenario: the next merge deletes the bucket once nobody pins it.
+  EXPECT_TRUE(ht.Insert(nullptr, 0, 0));
+  EXPECT_TRUE(ht.Remove(nullptr, 0, 0));
+  EXPECT_FALSE(disk_manager->IsPageAllocated(merged_page_id));
+  ht.VerifyIntegrity();
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.map");
+  delete disk_manager;
+  delete bpm;
+}
 }  // namespace bustub
@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_workload.h
+//
+// Identification: test/include/buffer/replacer_workload.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+#include "buffer/replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/**
+ * Replay a workload that interleaves point lookups of a small hot set with a sequential scan through a pool of the
+ * given size, and count the buffer hits. The replacer is driven the way the buffer pool drives it: a miss takes a
+ * victim and loads the page into its frame, every access is a pin followed by an unpin. The scan reads each tuple of
+ * a page back to back, i.e. it pins each of its pages tuples_per_page times in a row, then never comes back to it.
+ */
+inline size_t CountHits(Replacer *replacer, size_t pool_size, int tuples_per_page) {
+  const page_id_t num_hot_pages = 5;
+  std::unordered_map<page_id_t, frame_id_t> page_table;
+  std::unordered_map<frame_id_t, page_id_t> frame_to_page;
+  std::list<frame_id_t> free_list;
+  for (size_t i = 0; i < pool_size; i++) {
+    free_list.push_back(static_cast<frame_id_t>(i));
+  }
+  size_t hits = 0;
+  auto access = [&](page_id_t page_id) {
+    if (page_table.count(page_id) != 0) {
+      hits++;
+      replacer->Pin(page_table[page_id]);
+      replacer->Unpin(page_table[page_id]);
+      return;
+    }
+    frame_id_t frame_id;
+    if (!free_list.empty()) {
+      frame_id = free_list.front();
+      free_list.pop_front();
+    } else {
+      EXPECT_TRUE(replacer->Victim(&frame_id));
+      replacer->RecordEviction(frame_id, frame_to_page[frame_id]);
+      page_table.erase(frame_to_page[frame_id]);
+    }
+    page_table[page_id] = frame_id;
+    frame_to_page[frame_id] = page_id;
+    replacer->RecordLoad(frame_id, page_id);
+    replacer->Unpin(frame_id);
+  };
+
+  // The lookups run for a while before the report starts.
+  for (int round = 0; round < 2; round++) {
+    for (page_id_t page_id = 0; page_id < num_hot_pages; page_id++) {
+      access(page_id);
+    }
+  }
+  page_id_t next_scan_page = 1000;
+  for (int round = 0; round < 100; round++) {
+    for (page_id_t page_id = 0; page_id < num_hot_pages; page_id++) {
+      access(page_id);
+    }
+    for (size_t i = 0; i < pool_size; i++) {
+      for (int tuple = 0; tuple < tuples_per_page; tuple++) {
+        access(next_scan_page);
+      }
+      next_scan_page++;
+    }
+  }
+  return hits;
+}
+
+}  // namespace bustub
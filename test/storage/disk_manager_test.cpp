@@ -10,12 +10,29 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
+#include <mutex>  // NOLINT
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
 
+#include "buffer/buffer_pool_manager_instance.h"
 #include "common/exception.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
 
+// The benchmark is disabled by default. Run it with
+//   ./test/disk_manager_test --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+
 namespace bustub {
 
 class DiskManagerTest : public ::testing::Test {
@@ -24,12 +41,14 @@ class DiskManagerTest : public ::testing::Test {
   void SetUp() override {
     remove("test.db");
     remove("test.log");
+    remove("test.map");
   }
 
   // This function is called after every test.
   void TearDown() override {
     remove("test.db");
     remove("test.log");
+    remove("test.map");
   };
 };
 
@@ -55,6 +74,394 @@ TEST_F(DiskManagerTest, ReadWritePageTest) {
   dm.ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ReservePageTest) {
+  char buf[PAGE_SIZE];
+  char data[PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  // Reserving pages does not write them, and a reserved page that was never written reads as zeros.
+  dm.ReservePage(0);
+  dm.ReservePage(PREALLOCATE_PAGES + 1);
+  EXPECT_EQ(0, dm.GetNumWrites());
+  std::memset(buf, 1, sizeof(buf));
+  dm.ReadPage(PREALLOCATE_PAGES + 1, buf);
+  EXPECT_EQ(0, buf[0]);
+  EXPECT_EQ(0, buf[PAGE_SIZE - 1]);
+
+  dm.WritePage(1, data);
+  dm.ReadPage(1, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  // So does a page that was never reserved.
+  std::memset(buf, 1, sizeof(buf));
+  dm.ReadPage(4 * PREALLOCATE_PAGES, buf);
+  EXPECT_EQ(0, buf[0]);
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, AllocationMapTest) {
+  char buf[PAGE_SIZE];
+  char data[PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  std::strncpy(data, "A test string.", sizeof(data));
+  {
+    auto dm = DiskManager(db_file);
+    dm.AllocatePage(0);
+    dm.AllocatePage(3);
+    dm.AllocatePage(DiskManager::PAGES_PER_MAP_PAGE + 1);
+    EXPECT_TRUE(dm.IsPageAllocated(3));
+    EXPECT_FALSE(dm.IsPageAllocated(2));
+
+    // A deallocated page is free again and lost its content.
+    dm.WritePage(3, data);
+    dm.DeallocatePage(3);
+    EXPECT_FALSE(dm.IsPageAllocated(3));
+    dm.ReadPage(3, buf);
+    EXPECT_EQ(0, buf[0]);
+    dm.ShutDown();
+  }
+
+  // The allocation map survives a restart.
+  {
+    auto dm = DiskManager(db_file);
+    EXPECT_TRUE(dm.IsPageAllocated(0));
+    EXPECT_FALSE(dm.IsPageAllocated(3));
+    EXPECT_TRUE(dm.IsPageAllocated(DiskManager::PAGES_PER_MAP_PAGE + 1));
+    dm.ShutDown();
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, WritePagesTest) {
+  char buf[PAGE_SIZE];
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+  // More pages than a single pwritev takes.
+  const size_t num_pages = 1500;
+  std::vector<std::vector<char>> pages(num_pages, std::vector<char>(PAGE_SIZE));
+  std::vector<const char *> pages_data;
+  for (size_t i = 0; i < num_pages; i++) {
+    std::memset(pages[i].data(), static_cast<int>(i % 127) + 1, PAGE_SIZE);
+    pages_data.push_back(pages[i].data());
+  }
+  dm.WritePages(2, pages_data.data(), num_pages);
+  dm.Sync();
+  EXPECT_EQ(1, dm.GetNumWrites());
+  for (size_t i = 0; i < num_pages; i++) {
+    dm.ReadPage(static_cast<page_id_t>(i + 2), buf);
+    ASSERT_EQ(std::memcmp(buf, pages[i].data(), PAGE_SIZE), 0) << "page " << i + 2;
+  }
+  dm.ReadPage(1, buf);
+  EXPECT_EQ(0, buf[0]);
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, ConcurrentReadWriteTest) {
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+  const int num_threads = 4;
+  const int pages_per_thread = 64;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&dm, t] {
+      char data[PAGE_SIZE];
+      char buf[PAGE_SIZE];
+      // Every thread owns the pages t, t + num_threads, ... and checks it reads back what it wrote.
+      for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < pages_per_thread; i++) {
+          page_id_t page_id = i * num_threads + t;
+          std::memset(data, page_id + round, PAGE_SIZE);
+          dm.WritePage(page_id, data);
+          dm.ReadPage(page_id, buf);
+          ASSERT_EQ(std::memcmp(buf, data, PAGE_SIZE), 0);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_threads * pages_per_thread * 4, dm.GetNumWrites());
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, AsyncReadWriteTest) {
+  std::string db_file("test.db");
+  for (AsyncIoBackend backend : {AsyncIoBackend::IO_URING, AsyncIoBackend::THREAD_POOL}) {
+    auto dm = DiskManager(db_file, backend);
+    if (backend == AsyncIoBackend::THREAD_POOL) {
+      EXPECT_EQ(AsyncIoBackend::THREAD_POOL, dm.GetAsyncIoBackend());
+    }
+    // More pages than the io_uring holds, so that queueing has to make room.
+    const size_t num_pages = ASYNC_IO_QUEUE_DEPTH + 72;
+    std::vector<std::vector<char>> pages(num_pages, std::vector<char>(PAGE_SIZE));
+    std::vector<IoHandle> handles;
+    for (size_t i = 0; i < num_pages; i++) {
+      std::memset(pages[i].data(), static_cast<int>(i % 127) + 1, PAGE_SIZE);
+      handles.push_back(dm.WritePageAsync(static_cast<page_id_t>(i), pages[i].data()));
+    }
+    EXPECT_EQ(num_pages, dm.GetNumWrites());
+    dm.SubmitIo();
+    for (auto &handle : handles) {
+      EXPECT_TRUE(handle.Wait());
+      EXPECT_TRUE(handle.IsDone());
+    }
+
+    // Scenario: reads reaped in bulk see the writes, and a page past the end of the file reads as zeros.
+    std::vector<std::vector<char>> bufs(num_pages + 1, std::vector<char>(PAGE_SIZE, 1));
+    handles.clear();
+    for (size_t i = 0; i <= num_pages; i++) {
+      handles.push_back(dm.ReadPageAsync(static_cast<page_id_t>(i), bufs[i].data()));
+    }
+    dm.SubmitIo();
+    // Queueing past the size of the io_uring already reaped some, so reap until nothing is left in flight.
+    while (dm.ReapIo(handles.size()) > 0) {
+    }
+    for (size_t i = 0; i < num_pages; i++) {
+      EXPECT_TRUE(handles[i].IsDone());
+      ASSERT_EQ(std::memcmp(bufs[i].data(), pages[i].data(), PAGE_SIZE), 0) << "page " << i;
+    }
+    EXPECT_TRUE(handles[num_pages].Wait());
+    EXPECT_EQ(0, bufs[num_pages][0]);
+    EXPECT_EQ(0, bufs[num_pages][PAGE_SIZE - 1]);
+
+    // Scenario: a run of pages in one write, waited for without an explicit submit.
+    const char *run[] = {pages[2].data(), pages[1].data(), pages[0].data()};
+    EXPECT_TRUE(dm.WritePagesAsync(10, run, 3).Wait());
+    char buf[PAGE_SIZE];
+    for (int i = 0; i < 3; i++) {
+      dm.ReadPage(10 + i, buf);
+      EXPECT_EQ(std::memcmp(buf, run[i], PAGE_SIZE), 0);
+    }
+
+    // Scenario: requests still in flight complete before the shutdown.
+    for (size_t i = 0; i < num_pages; i++) {
+      dm.WritePageAsync(static_cast<page_id_t>(i), pages[0].data());
+    }
+    dm.SubmitIo();
+    dm.ShutDown();
+    remove("test.db");
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, DirectIoTest) {
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file, AsyncIoBackend::AUTO, DiskIoMode::DIRECT);
+  if (dm.GetIoMode() != DiskIoMode::DIRECT) {
+    GTEST_SKIP() << "the file system does not support O_DIRECT";
+  }
+  auto *aligned = static_cast<char *>(aligned_alloc(DiskManager::DIRECT_IO_ALIGNMENT, 4 * PAGE_SIZE));
+  // One byte off, so that O_DIRECT refuses it and the disk manager has to copy.
+  std::vector<char> unaligned_storage(PAGE_SIZE + DiskManager::DIRECT_IO_ALIGNMENT);
+  char *unaligned = unaligned_storage.data();
+  while (reinterpret_cast<uintptr_t>(unaligned) % DiskManager::DIRECT_IO_ALIGNMENT != 1) {
+    unaligned++;
+  }
+
+  // Scenario: aligned and unaligned buffers both round trip.
+  std::memset(aligned, 'a', PAGE_SIZE);
+  std::memset(unaligned, 'u', PAGE_SIZE);
+  dm.WritePage(0, aligned);
+  dm.WritePage(1, unaligned);
+  dm.ReadPage(1, aligned + PAGE_SIZE);
+  EXPECT_EQ(std::memcmp(aligned + PAGE_SIZE, unaligned, PAGE_SIZE), 0);
+  dm.ReadPage(0, unaligned);
+  EXPECT_EQ(std::memcmp(aligned, unaligned, PAGE_SIZE), 0);
+
+  // Scenario: a run mixing both kinds of buffers, written synchronously and asynchronously.
+  std::memset(aligned + PAGE_SIZE, 'b', PAGE_SIZE);
+  std::memset(unaligned, 'v', PAGE_SIZE);
+  const char *run[] = {aligned, unaligned, aligned + PAGE_SIZE};
+  dm.WritePages(2, run, 3);
+  EXPECT_TRUE(dm.WritePagesAsync(5, run, 3).Wait());
+  for (int i = 0; i < 3; i++) {
+    EXPECT_TRUE(dm.ReadPageAsync(2 + i, aligned + 2 * PAGE_SIZE).Wait());
+    EXPECT_EQ(std::memcmp(aligned + 2 * PAGE_SIZE, run[i], PAGE_SIZE), 0);
+    dm.ReadPage(5 + i, aligned + 3 * PAGE_SIZE);
+    EXPECT_EQ(std::memcmp(aligned + 3 * PAGE_SIZE, run[i], PAGE_SIZE), 0);
+  }
+  EXPECT_TRUE(dm.WritePageAsync(8, unaligned).Wait());
+  std::vector<char> expected(unaligned, unaligned + PAGE_SIZE);
+  std::memset(unaligned, 0, PAGE_SIZE);
+  EXPECT_TRUE(dm.ReadPageAsync(8, unaligned).Wait());
+  EXPECT_EQ(std::memcmp(unaligned, expected.data(), PAGE_SIZE), 0);
+
+  // Scenario: a deallocated page and a page past the end of the file read as zeros.
+  dm.AllocatePage(0);
+  dm.DeallocatePage(0);
+  dm.ReadPage(0, unaligned);
+  EXPECT_EQ(0, unaligned[0]);
+  dm.ReadPage(1000, aligned);
+  EXPECT_EQ(0, aligned[PAGE_SIZE - 1]);
+  free(aligned);
+
+  // Scenario: the buffer pool hands its frames to O_DIRECT as they are, evicting and reading pages back.
+  auto *bpm = new BufferPoolManagerInstance(2, &dm);
+  page_id_t page_ids[4];
+  for (auto &page_id : page_ids) {
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(page->GetData()) % DiskManager::DIRECT_IO_ALIGNMENT);
+    std::snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  for (auto page_id : page_ids) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  delete bpm;
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, LargeFileTest) {
+  char buf[PAGE_SIZE];
+  char data[PAGE_SIZE];
+  std::string db_file("test.db");
+  // Past 4 GB, where a 32-bit offset wraps around. The file is sparse, only the written pages take disk space.
+  const page_id_t far_page_id = static_cast<page_id_t>((int64_t{5} << 30) / PAGE_SIZE);
+  {
+    auto dm = DiskManager(db_file);
+    std::memset(data, 'x', PAGE_SIZE);
+    dm.WritePage(far_page_id, data);
+    std::memset(data, 'y', PAGE_SIZE);
+    dm.WritePage(1, data);
+    dm.ReadPage(far_page_id, buf);
+    EXPECT_EQ('x', buf[0]);
+    dm.ReadPage(far_page_id + 1, buf);
+    EXPECT_EQ(0, buf[PAGE_SIZE - 1]);
+    dm.ShutDown();
+  }
+
+  // Scenario: a reopened disk manager picks up the size of the file.
+  auto dm = DiskManager(db_file);
+  dm.ReadPage(far_page_id, buf);
+  EXPECT_EQ('x', buf[PAGE_SIZE - 1]);
+  dm.ReadPage(1, buf);
+  EXPECT_EQ('y', buf[0]);
+  dm.ReadPage(far_page_id - 1, buf);
+  EXPECT_EQ(0, buf[0]);
+  dm.ShutDown();
+  remove(dm.GetSegmentPath(far_page_id / dm.GetSegmentPages()).c_str());
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, SegmentTest) {
+  char buf[PAGE_SIZE];
+  std::string db_file("test.db");
+  const page_id_t segment_pages = 16;
+  std::vector<std::string> segment_dirs = {"test_segments_a", "test_segments_b"};
+  for (const auto &dir : segment_dirs) {
+    mkdir(dir.c_str(), 0755);
+  }
+  std::vector<std::vector<char>> pages(3 * segment_pages, std::vector<char>(PAGE_SIZE));
+  std::vector<const char *> pages_data;
+  for (size_t i = 0; i < pages.size(); i++) {
+    std::memset(pages[i].data(), static_cast<int>(i) + 1, PAGE_SIZE);
+    pages_data.push_back(pages[i].data());
+  }
+  {
+    auto dm = DiskManager(db_file, AsyncIoBackend::AUTO, DiskIoMode::BUFFERED, segment_pages, segment_dirs);
+    EXPECT_EQ("test.db", dm.GetSegmentPath(0));
+    EXPECT_EQ("test_segments_a/test.db.1", dm.GetSegmentPath(1));
+    EXPECT_EQ("test_segments_b/test.db.2", dm.GetSegmentPath(2));
+    EXPECT_EQ("test_segments_a/test.db.3", dm.GetSegmentPath(3));
+
+    // Scenario: a run crossing segment boundaries lands in the files of its segments.
+    dm.WritePages(4, pages_data.data(), 2 * segment_pages);
+    EXPECT_TRUE(dm.WritePagesAsync(2 * segment_pages + 4, pages_data.data(), 4).Wait());
+    for (page_id_t page_id = 4; page_id < 2 * segment_pages + 4; page_id++) {
+      dm.ReadPage(page_id, buf);
+      ASSERT_EQ(std::memcmp(buf, pages[page_id - 4].data(), PAGE_SIZE), 0) << "page " << page_id;
+    }
+    struct stat stat_buf;
+    ASSERT_EQ(0, stat(dm.GetSegmentPath(1).c_str(), &stat_buf));
+    EXPECT_EQ(segment_pages * PAGE_SIZE, stat_buf.st_size);
+
+    // Scenario: preallocation stops at the end of the segment.
+    dm.AllocatePage(3 * segment_pages + 1);
+    ASSERT_EQ(0, stat(dm.GetSegmentPath(3).c_str(), &stat_buf));
+    EXPECT_EQ(segment_pages * PAGE_SIZE, stat_buf.st_size);
+    dm.ShutDown();
+  }
+
+  {
+    // Scenario: a reopened disk manager finds its segments, and unlinks a segment once all its pages are free.
+    auto dm = DiskManager(db_file, AsyncIoBackend::AUTO, DiskIoMode::BUFFERED, segment_pages, segment_dirs);
+    dm.ReadPage(2 * segment_pages + 5, buf);
+    EXPECT_EQ(std::memcmp(buf, pages[1].data(), PAGE_SIZE), 0);
+    dm.AllocatePage(2 * segment_pages);
+    dm.AllocatePage(2 * segment_pages + 1);
+    dm.DeallocatePage(2 * segment_pages);
+    EXPECT_EQ(0, access(dm.GetSegmentPath(2).c_str(), F_OK));
+    dm.DeallocatePage(2 * segment_pages + 1);
+    EXPECT_NE(0, access(dm.GetSegmentPath(2).c_str(), F_OK));
+    dm.ReadPage(2 * segment_pages + 5, buf);
+    EXPECT_EQ(0, buf[0]);
+    dm.ReadPage(segment_pages, buf);
+    EXPECT_EQ(std::memcmp(buf, pages[segment_pages - 4].data(), PAGE_SIZE), 0);
+
+    // Scenario: a dropped segment comes back on the next write.
+    dm.WritePage(2 * segment_pages + 5, pages[7].data());
+    dm.ReadPage(2 * segment_pages + 5, buf);
+    EXPECT_EQ(std::memcmp(buf, pages[7].data(), PAGE_SIZE), 0);
+
+    // Scenario: a dropped segment does not keep its descriptor open, and is not created again by a read.
+    auto count_open_fds = [] {
+      size_t count = 0;
+      DIR *dir_stream = opendir("/proc/self/fd");
+      while (dir_stream != nullptr && readdir(dir_stream) != nullptr) {
+        count++;
+      }
+      if (dir_stream != nullptr) {
+        closedir(dir_stream);
+      }
+      return count;
+    };
+    size_t num_open_fds = 0;
+    for (int i = 0; i < 100; i++) {
+      EXPECT_TRUE(dm.WritePageAsync(4 * segment_pages, pages[i % pages.size()].data()).Wait());
+      dm.AllocatePage(4 * segment_pages);
+      dm.DeallocatePage(4 * segment_pages);
+      ASSERT_NE(0, access(dm.GetSegmentPath(4).c_str(), F_OK));
+      dm.ReadPage(4 * segment_pages, buf);
+      EXPECT_EQ(0, buf[0]);
+      ASSERT_NE(0, access(dm.GetSegmentPath(4).c_str(), F_OK));
+      if (i == 0) {
+        num_open_fds = count_open_fds();
+      }
+    }
+    EXPECT_EQ(num_open_fds, count_open_fds());
+    dm.ShutDown();
+  }
+
+  {
+    // Scenario: a new database does not pick up the segments of a former one.
+    remove("test.db");
+    auto dm = DiskManager(db_file, AsyncIoBackend::AUTO, DiskIoMode::BUFFERED, segment_pages, segment_dirs);
+    EXPECT_NE(0, access(dm.GetSegmentPath(1).c_str(), F_OK));
+    dm.ReadPage(segment_pages, buf);
+    EXPECT_EQ(0, buf[0]);
+    dm.ShutDown();
+  }
+  for (const auto &dir : segment_dirs) {
+    rmdir(dir.c_str());
+  }
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ReadWriteLogTest) {
   char buf[16] = {0};
@@ -72,6 +479,115 @@ TEST_F(DiskManagerTest, ReadWriteLogTest) {
   dm.ShutDown();
 }
 
+/** How the DiskManager read pages before it used pread: one stream, seek and read under a latch. */
+class StreamPageReader {
+ public:
+  explicit StreamPageReader(const std::string &db_file) : db_io_(db_file, std::ios::binary | std::ios::in) {}
+
+  void ReadPage(page_id_t page_id, char *page_data) {
+    std::scoped_lock scoped_db_io_latch(db_io_latch_);
+    db_io_.seekp(static_cast<size_t>(page_id) * PAGE_SIZE);
+    db_io_.read(page_data, PAGE_SIZE);
+  }
+
+ private:
+  std::fstream db_io_;
+  std::mutex db_io_latch_;
+};
+
+/** Read random pages from num_threads threads, and return the reads per second. */
+template <typename Reader>
+double RandomReadIops(Reader *reader, int num_threads, page_id_t num_pages, int reads_per_thread) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([reader, t, num_pages, reads_per_thread] {
+      std::mt19937 gen(t);
+      std::uniform_int_distribution<page_id_t> page_ids(0, num_pages - 1);
+      char buf[PAGE_SIZE];
+      for (int i = 0; i < reads_per_thread; i++) {
+        reader->ReadPage(page_ids(gen), buf);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return num_threads * reads_per_thread / seconds;
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, DISABLED_RandomReadBenchmark) {
+  std::string db_file("test.db");
+  const page_id_t num_pages = 16384;
+  const int reads_per_thread = 100000;
+  auto dm = DiskManager(db_file);
+  char data[PAGE_SIZE];
+  for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+    std::memset(data, page_id, PAGE_SIZE);
+    dm.WritePage(page_id, data);
+  }
+  dm.Sync();
+
+  StreamPageReader stream_reader(db_file);
+  for (int num_threads : {1, 2, 4, 8}) {
+    double stream_iops = RandomReadIops(&stream_reader, num_threads, num_pages, reads_per_thread);
+    double pread_iops = RandomReadIops(&dm, num_threads, num_pages, reads_per_thread);
+    printf("threads=%d  fstream+latch: %.0f reads/s  pread: %.0f reads/s  speedup: %.2fx\n", num_threads, stream_iops,
+           pread_iops, pread_iops / stream_iops);
+  }
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, DISABLED_AsyncRandomReadBenchmark) {
+  std::string db_file("test.db");
+  const page_id_t num_pages = 16384;
+  const int num_reads = 200000;
+  const int queue_depth = 32;
+  {
+    auto dm = DiskManager(db_file);
+    char data[PAGE_SIZE];
+    for (page_id_t page_id = 0; page_id < num_pages; page_id++) {
+      std::memset(data, page_id, PAGE_SIZE);
+      dm.WritePage(page_id, data);
+    }
+    dm.ShutDown();
+  }
+
+  for (AsyncIoBackend backend : {AsyncIoBackend::IO_URING, AsyncIoBackend::THREAD_POOL}) {
+    auto dm = DiskManager(db_file, backend);
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<page_id_t> page_ids(0, num_pages - 1);
+    std::vector<std::vector<char>> bufs(queue_depth, std::vector<char>(PAGE_SIZE));
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_reads; i++) {
+      dm.ReadPage(page_ids(gen), bufs[0].data());
+    }
+    double sync_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // queue_depth reads in flight at a time, submitted and reaped in batches.
+    start = std::chrono::steady_clock::now();
+    std::vector<IoHandle> handles(queue_depth);
+    for (int i = 0; i < num_reads; i += queue_depth) {
+      for (int j = 0; j < queue_depth; j++) {
+        handles[j] = dm.ReadPageAsync(page_ids(gen), bufs[j].data());
+      }
+      dm.SubmitIo();
+      for (auto &handle : handles) {
+        handle.Wait();
+      }
+    }
+    double async_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%s  sync pread: %.0f reads/s  async, queue depth %d: %.0f reads/s\n",
+           dm.GetAsyncIoBackend() == AsyncIoBackend::IO_URING ? "io_uring   " : "thread pool", num_reads / sync_seconds,
+           queue_depth, num_reads / async_seconds);
+    dm.ShutDown();
+  }
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ThrowBadFileTest) { EXPECT_THROW(DiskManager("dev/null\\/foo/bar/baz/test.db"), Exception); }
 
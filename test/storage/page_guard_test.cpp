@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_guard_test.cpp
+//
+// Identification: test/storage/page_guard_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/page/page_guard.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PageGuardTest, UnpinOnScopeExitTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(2, disk_manager);
+
+  page_id_t page_id;
+  Page *page = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+
+  // Scenario: a read guard holds the pin until it goes out of scope, and does not dirty the page.
+  {
+    ReadPageGuard guard = bpm->FetchPageRead(page_id);
+    ASSERT_TRUE(guard);
+    EXPECT_EQ(page_id, guard.PageId());
+    EXPECT_EQ(1, page->GetPinCount());
+  }
+  EXPECT_EQ(0, page->GetPinCount());
+  EXPECT_FALSE(page->IsDirty());
+
+  // Scenario: a write guard dirties the page once it is written through.
+  {
+    WritePageGuard guard = bpm->FetchPageWrite(page_id);
+    ASSERT_TRUE(guard);
+    EXPECT_FALSE(page->IsDirty());
+    strcpy(guard.GetDataMut(), "guarded");  // NOLINT
+  }
+  EXPECT_EQ(0, page->GetPinCount());
+  EXPECT_TRUE(page->IsDirty());
+
+  // Scenario: a write guard read through a plain view leaves the page clean, unless it is marked dirty.
+  EXPECT_TRUE(bpm->FlushPage(page_id));
+  EXPECT_FALSE(page->IsDirty());
+  {
+    WritePageGuard guard = bpm->FetchPageWrite(page_id);
+    EXPECT_EQ(page, guard.PageAs<Page>());
+  }
+  EXPECT_FALSE(page->IsDirty());
+  {
+    WritePageGuard guard = bpm->FetchPageWrite(page_id);
+    guard.MarkDirty();
+  }
+  EXPECT_TRUE(page->IsDirty());
+
+  // Scenario: moving a guard moves the pin, which is given back exactly once.
+  {
+    ReadPageGuard guard = bpm->FetchPageRead(page_id);
+    ReadPageGuard other = std::move(guard);
+    EXPECT_FALSE(guard);  // NOLINT
+    ASSERT_TRUE(other);
+    EXPECT_EQ(0, std::strcmp("guarded", other.GetData()));
+    EXPECT_EQ(1, page->GetPinCount());
+    other.Drop();
+    EXPECT_EQ(0, page->GetPinCount());
+  }
+  EXPECT_EQ(0, page->GetPinCount());
+
+  // Scenario: the latch is given back too, so the page can be write-latched again.
+  {
+    ReadPageGuard first = bpm->FetchPageRead(page_id);
+    ReadPageGuard second = bpm->FetchPageRead(page_id);
+    EXPECT_EQ(2, page->GetPinCount());
+  }
+  WritePageGuard write_guard = bpm->FetchPageWrite(page_id);
+  EXPECT_EQ(1, page->GetPinCount());
+  write_guard.Drop();
+
+  // Scenario: an empty guard comes back when the page cannot be fetched.
+  page_id_t pinned_page_ids[2];
+  for (auto &pinned_page_id : pinned_page_ids) {
+    ASSERT_NE(nullptr, bpm->NewPage(&pinned_page_id));
+  }
+  EXPECT_FALSE(bpm->FetchPageRead(page_id));
+  EXPECT_FALSE(bpm->FetchPageWrite(page_id));
+  for (auto pinned_page_id : pinned_page_ids) {
+    EXPECT_TRUE(bpm->UnpinPage(pinned_page_id, false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  remove("test.map");
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub